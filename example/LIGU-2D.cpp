@@ -55,7 +55,7 @@ int main()
 		g.PaintSize = 3; g.PaintColor = 0xCCFF66; g.drawEllipse(1000, 1000, 200, 500);
 		g.PaintColor = 0xCCFF00; g.drawRectangle(1900, 100, 1600, 400);
 		g.fillRectangle(1800, 200, 1700, 300, 0xCCFF00);
-		g.TransMat.E(3);
+		g.resetTrans();
 	}
 	{ // Translucent
 		int sx = 280, sy = 250;
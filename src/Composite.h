@@ -0,0 +1,201 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef COMPOSITE_H
+#define COMPOSITE_H
+#include <stdlib.h>
+#include "../../LiGu_AlgorithmLib/Mat.h"
+#include "RGB.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(COMPOSITE_NO_DISPATCH)
+#define COMPOSITE_DISPATCH
+#define COMPOSITE_INLINE inline __attribute__((always_inline))
+#else
+#define COMPOSITE_INLINE inline
+#endif
+namespace Composite {
+/******************************************************************************
+*                    图层混合 [ Composite ]
+*	[目的]: RGB.h 的 ChannelBlend_* 宏一次只算一个像素的一个通道, 整图混合需逐像素调用.
+			此处将 25 种模式作用于整幅 Mat<RGB>, 结果与宏逐位一致.
+*	[约定]: A 为上层 (src), B 为下层 (dst), 同 ColorBlend_*(T, A, B): dst = M(src, dst).
+			(x0, y0): src 左上角在 dst 中的位置, x 为第一维 (行); 越界部分裁剪.
+			opacity / mask: 不透明度 (0xFF: 完全覆盖), mask 与 src 同尺寸, 逐像素.
+			结果再与原 dst 混合: dst = (w·M + (255 - w)·dst) / 255, w = opacity·mask / 255, 8 位定点四舍五入.
+*	[算法]:
+		[1] 按字节计算, 每次处理 BLOCK = 32 像素 (96 字节), 内层为定长、无分支的整数运算
+			(比较改为选择, /255 改为乘法移位), 由编译器生成 SIMD 指令.
+		[2] 含变量除法或浮点的模式 (SoftLight, ColorDodge, ColorBurn, VividLight, HardMix, Reflect, Glow),
+			由宏本身生成 256x256 查找表 (首次使用时), 逐字节查表.
+		[3] 运行时分派: GCC/Clang x86 下每个内核另编译一份 AVX2 版本, 按 CPU 支持选用;
+			其他编译器只有通用版本 (向量宽度取决于编译选项).
+		[4] 按行多线程.
+-------------------------------------------------------------------------------
+void blend	(Mat<RGB>& dst, Mat<RGB>& src, Mode mode, int x0 = 0, int y0 = 0, INT8U opacity = 0xFF, Mat<INT8U>* mask = NULL);
+******************************************************************************/
+enum Mode {
+	BLEND_NORMAL,		BLEND_LIGHTEN,		BLEND_DARKEN,		BLEND_MULTIPLY,		BLEND_AVERAGE,
+	BLEND_ADD,			BLEND_SUBTRACT,		BLEND_DIFFERENCE,	BLEND_NEGATION,		BLEND_SCREEN,
+	BLEND_EXCLUSION,	BLEND_OVERLAY,		BLEND_SOFT_LIGHT,	BLEND_HARD_LIGHT,	BLEND_COLOR_DODGE,
+	BLEND_COLOR_BURN,	BLEND_LINEAR_DODGE,	BLEND_LINEAR_BURN,	BLEND_LINEAR_LIGHT,	BLEND_VIVID_LIGHT,
+	BLEND_PIN_LIGHT,	BLEND_HARD_MIX,		BLEND_REFLECT,		BLEND_GLOW,			BLEND_PHOENIX,
+	BLEND_MODE_NUM
+};
+enum { BLOCK = 32, BYTES = BLOCK * 3 };
+/*---------------- 供 ChannelBlend_* 宏使用 ----------------*/
+static inline int min(int a, int b) { return a < b ? a : b; }
+static inline int max(int a, int b) { return a > b ? a : b; }
+/*---------------- x / 255: 向下取整 (x <= 2·255²), 四舍五入 (x <= 255²) ----------------*/
+static COMPOSITE_INLINE int div255(int x) {
+	unsigned int q = ((unsigned int)x * 0x8081u) >> 23;
+	return q - (q * 255 > (unsigned int)x);
+}
+static COMPOSITE_INLINE int div255Round(int x) { x += 0x80; return (x + (x >> 8)) >> 8; }
+/******************************************************************************
+*                    算术模式: 与宏等价的无分支整数形式
+******************************************************************************/
+#define COMPOSITE_OP(NAME, EXPR) \
+struct Op##NAME { COMPOSITE_INLINE int operator()(int a, int b) const { return (INT8U)(EXPR); } };
+COMPOSITE_OP(Normal,		a)
+COMPOSITE_OP(Lighten,		b > a ? b : a)
+COMPOSITE_OP(Darken,		b > a ? a : b)
+COMPOSITE_OP(Multiply,		div255(a * b))
+COMPOSITE_OP(Average,		(a + b) >> 1)
+COMPOSITE_OP(Add,			min(0xFF, a + b))
+COMPOSITE_OP(Subtract,		a + b < 0xFF ? 0 : a + b - 0xFF)
+COMPOSITE_OP(Difference,	a > b ? a - b : b - a)
+COMPOSITE_OP(Negation,		0xFF - (a + b > 0xFF ? a + b - 0xFF : 0xFF - a - b))
+COMPOSITE_OP(Screen,		0xFF - (((0xFF - a) * (0xFF - b)) >> 8))
+COMPOSITE_OP(Exclusion,		a + b - div255(2 * a * b))
+COMPOSITE_OP(Overlay,		b < 0x80 ? div255(2 * a * b) : 0xFF - div255(2 * (0xFF - a) * (0xFF - b)))
+COMPOSITE_OP(HardLight,		a < 0x80 ? div255(2 * a * b) : 0xFF - div255(2 * (0xFF - a) * (0xFF - b)))
+COMPOSITE_OP(LinearLight,	b < 0x80 ? (a + 2 * b < 0xFF ? 0 : a + 2 * b - 0xFF) : min(0xFF, a + 2 * b - 0x100))
+COMPOSITE_OP(PinLight,		b < 0x80 ? min(a, 2 * b) : max(a, 2 * b - 0x100))
+COMPOSITE_OP(Phoenix,		min(a, b) - max(a, b) + 0xFF)
+#undef COMPOSITE_OP
+/******************************************************************************
+*                    查表模式: 表由 RGB.h 的宏直接生成
+******************************************************************************/
+template<int M>
+static INT8U* buildTable() {
+	INT8U* t = (INT8U*)malloc(0x10000);
+	for (int A = 0; A < 0x100; A++)
+		for (int B = 0; B < 0x100; B++) {
+			INT8U& T = t[A << 8 | B];
+			switch (M) {
+			case BLEND_SOFT_LIGHT:  T = ChannelBlend_SoftLight (A, B); break;
+			case BLEND_COLOR_DODGE: T = ChannelBlend_ColorDodge(A, B); break;
+			case BLEND_COLOR_BURN:  T = ChannelBlend_ColorBurn (A, B); break;
+			case BLEND_VIVID_LIGHT: T = ChannelBlend_VividLight(A, B); break;
+			case BLEND_HARD_MIX:    T = ChannelBlend_HardMix   (A, B); break;
+			case BLEND_REFLECT:     T = ChannelBlend_Reflect   (A, B); break;
+			case BLEND_GLOW:        T = ChannelBlend_Glow      (A, B); break;
+			}
+		}
+	return t;
+}
+template<int M>
+static const INT8U* table() { static const INT8U* t = buildTable<M>(); return t; }	//有意不释放, 同 ThreadPool
+template<int M>
+struct OpTable {
+	const INT8U* t;
+	OpTable() : t(table<M>()) { ; }
+	COMPOSITE_INLINE int operator()(int a, int b) const { return t[a << 8 | b]; }
+};
+/******************************************************************************
+*                    行内核
+******************************************************************************/
+/*---------------- len 字节: d = M(s, d), w != NULL 时再按权重 w 与原 d 混合 ----------------*/
+template<class F>
+static COMPOSITE_INLINE void blendBytes(const F& op, INT8U* __restrict d, const INT8U* __restrict s, const INT8U* __restrict w, int len) {
+	INT8U t[BYTES];
+	for (int k = 0; k < len; k++) t[k] = op(s[k], d[k]);
+	if (w == NULL) for (int k = 0; k < len; k++) d[k] = t[k];
+	else for (int k = 0; k < len; k++) d[k] = div255Round(w[k] * t[k] + (0xFF - w[k]) * d[k]);
+}
+/*---------------- 一行 n 像素, m: 该行 mask (可为 NULL) ----------------*/
+template<class F>
+static COMPOSITE_INLINE void blendRow(INT8U* d, const INT8U* s, const INT8U* m, int opacity, int n) {
+	F op;
+	INT8U w[BYTES];
+	bool isMix = m != NULL || opacity != 0xFF;
+	if (m == NULL) for (int k = 0; k < BYTES; k++) w[k] = opacity;
+	int bytes = n * 3;
+	for (int i = 0; i < bytes; i += BYTES, m += m == NULL ? 0 : BLOCK) {
+		int len = bytes - i < BYTES ? bytes - i : BYTES;
+		if (m != NULL)
+			for (int k = 0; k < len; k++) w[k] = div255Round(opacity * m[k / 3]);
+		if (len == BYTES) blendBytes(op, d + i, s + i, isMix ? w : NULL, BYTES);
+		else			  blendBytes(op, d + i, s + i, isMix ? w : NULL, len);
+	}
+}
+typedef void (*RowFunc)(INT8U* d, const INT8U* s, const INT8U* m, int opacity, int n);
+template<class F>
+struct Kernel {
+	static void row(INT8U* d, const INT8U* s, const INT8U* m, int opacity, int n) { blendRow<F>(d, s, m, opacity, n); }
+#ifdef COMPOSITE_DISPATCH
+	__attribute__((target("avx2")))
+	static void rowAVX2(INT8U* d, const INT8U* s, const INT8U* m, int opacity, int n) { blendRow<F>(d, s, m, opacity, n); }
+#endif
+	static RowFunc get() {
+#ifdef COMPOSITE_DISPATCH
+		static bool isAVX2 = __builtin_cpu_supports("avx2");
+		if (isAVX2) return rowAVX2;
+#endif
+		return row;
+	}
+};
+static RowFunc kernel(Mode mode) {
+	switch (mode) {
+	case BLEND_NORMAL:		return Kernel<OpNormal>		::get();
+	case BLEND_LIGHTEN:		return Kernel<OpLighten>	::get();
+	case BLEND_DARKEN:		return Kernel<OpDarken>		::get();
+	case BLEND_MULTIPLY:	return Kernel<OpMultiply>	::get();
+	case BLEND_AVERAGE:		return Kernel<OpAverage>	::get();
+	case BLEND_ADD:			return Kernel<OpAdd>		::get();
+	case BLEND_SUBTRACT:	return Kernel<OpSubtract>	::get();
+	case BLEND_DIFFERENCE:	return Kernel<OpDifference>	::get();
+	case BLEND_NEGATION:	return Kernel<OpNegation>	::get();
+	case BLEND_SCREEN:		return Kernel<OpScreen>		::get();
+	case BLEND_EXCLUSION:	return Kernel<OpExclusion>	::get();
+	case BLEND_OVERLAY:		return Kernel<OpOverlay>	::get();
+	case BLEND_SOFT_LIGHT:	return Kernel<OpTable<BLEND_SOFT_LIGHT>>	::get();
+	case BLEND_HARD_LIGHT:	return Kernel<OpHardLight>	::get();
+	case BLEND_COLOR_DODGE:	return Kernel<OpTable<BLEND_COLOR_DODGE>>	::get();
+	case BLEND_COLOR_BURN:	return Kernel<OpTable<BLEND_COLOR_BURN>>	::get();
+	case BLEND_LINEAR_DODGE:return Kernel<OpAdd>		::get();
+	case BLEND_LINEAR_BURN:	return Kernel<OpSubtract>	::get();
+	case BLEND_LINEAR_LIGHT:return Kernel<OpLinearLight>::get();
+	case BLEND_VIVID_LIGHT:	return Kernel<OpTable<BLEND_VIVID_LIGHT>>	::get();
+	case BLEND_PIN_LIGHT:	return Kernel<OpPinLight>	::get();
+	case BLEND_HARD_MIX:	return Kernel<OpTable<BLEND_HARD_MIX>>		::get();
+	case BLEND_REFLECT:		return Kernel<OpTable<BLEND_REFLECT>>		::get();
+	case BLEND_GLOW:		return Kernel<OpTable<BLEND_GLOW>>			::get();
+	case BLEND_PHOENIX:		return Kernel<OpPhoenix>	::get();
+	default: Mat<RGB>::error(); return NULL;
+	}
+}
+/*---------------- 混合 [blend] ----------------*/
+static void blend(Mat<RGB>& dst, Mat<RGB>& src, Mode mode, int x0 = 0, int y0 = 0, INT8U opacity = 0xFF, Mat<INT8U>* mask = NULL) {
+	if (mask != NULL && (mask->rows != src.rows || mask->cols != src.cols)) Mat<RGB>::error();
+	RowFunc f = kernel(mode);
+	int sx = x0 < 0 ? -x0 : 0, ex = src.rows + x0 < dst.rows ? src.rows : dst.rows - x0,
+		sy = y0 < 0 ? -y0 : 0, ey = src.cols + y0 < dst.cols ? src.cols : dst.cols - y0;
+	if (sx >= ex || sy >= ey || opacity == 0) return;
+	int n = ey - sy;
+	Parallel::parallelFor(ex - sx, (1 << 15) / n + 1, [&](int st, int ed) {
+		for (int x = sx + st; x < sx + ed; x++)
+			f((INT8U*)&dst(x + x0, sy + y0), (const INT8U*)&src(x, sy),
+			  mask == NULL ? NULL : &(*mask)(x, sy), opacity, n);
+	});
+}
+}
+#endif
@@ -234,6 +234,7 @@ Mat<>* Geometry::ConvexHull(Mat<> point[], int n, int& ansPointNum) {
 *************************************************************************************************/
 Mat<>* Geometry::Delaunay(Mat<> point[], int n, int& TrianglesNum) {
 	std::vector<Mat<>> triAns, triTemp, edgeBuffer;
+	MatArena::Scope arenaScope;											// 中间三角形/边由内存池分配
 	std::sort(point, point + n, [](Mat<>& a, Mat<>& b) {				// 将点按坐标x从小到大排序
 		return a[0] != b[0] ? a[0] < b[0] : a[1] < b[1];
 	});
@@ -264,22 +265,22 @@ Mat<>* Geometry::Delaunay(Mat<> point[], int n, int& TrianglesNum) {
 			double distance = (temp.sub(point[i], center)).norm();
 			//[3.2.2]
 			if (point[i][0] > center[0] + R) {
-				triAns.push_back(triTemp[j]);
+				triAns.push_back(std::move(triTemp[j]));
 				triTemp.erase(triTemp.begin() + j--);
 			}
 			//[3.2.4]
 			else if (distance < R) {
-				Mat<> edge(2, 2), p1, p2;
+				Mat<> edge(2, 2);
 				for (int k = 0; k < 3; k++) {
-					triTemp[j].getCol(k, p1); 
-					triTemp[j].getCol((k + 1) % 3, p2);
+					MatView<> p1 = triTemp[j].col(k), 
+							  p2 = triTemp[j].col((k + 1) % 3);
 					if (p1[0] < p2[0] || (p1[0] == p2[0] && p1[1] < p2[1])) { 
-						edge.setCol(0, p1); 
-						edge.setCol(1, p2); 
+						edge.col(0) = p1; 
+						edge.col(1) = p2; 
 					}
 					else { 
-						edge.setCol(0, p2);
-						edge.setCol(1, p1);
+						edge.col(0) = p2;
+						edge.col(1) = p1;
 					}
 					edgeBuffer.push_back(edge);
 				}
@@ -287,12 +288,12 @@ Mat<>* Geometry::Delaunay(Mat<> point[], int n, int& TrianglesNum) {
 			}
 		}
 		//[3.3] 
-		std::sort(edgeBuffer.begin(), edgeBuffer.end(), [](Mat<> a, Mat<> b) {
+		std::sort(edgeBuffer.begin(), edgeBuffer.end(), [](Mat<>& a, Mat<>& b) {
 			if (a(0, 0) < b(0, 0) || (a(0, 0) == b(0, 0) && a(1, 0) < b(1, 0)))return true;
 			if (a(0, 1) < b(0, 1) || (a(0, 1) == b(0, 1) && a(1, 1) < b(1, 1)))return true;
 			return false;
 		});
-		for (int j = 0; j < edgeBuffer.size() - 1; j++) {
+		for (int j = 0; j + 1 < edgeBuffer.size(); j++) {
 			bool flag = 0;
 			while (j + 1 < edgeBuffer.size() && edgeBuffer[j] == edgeBuffer[j + 1]) {
 				edgeBuffer.erase(edgeBuffer.begin() + j + 1); flag = 1;
@@ -301,25 +302,25 @@ Mat<>* Geometry::Delaunay(Mat<> point[], int n, int& TrianglesNum) {
 		}
 		//[3.4] 
 		for (int j = 0; j < edgeBuffer.size(); j++) {
-			Mat<> t(2, 3), temp;
-			t.setCol(0, edgeBuffer[j].getCol(0, temp)); 
-			t.setCol(1, edgeBuffer[j].getCol(1, temp)); 
-			t.setCol(2, point[i]);
-			triTemp.push_back(t);
+			Mat<> t(2, 3);
+			t.col(0) = edgeBuffer[j].col(0); 
+			t.col(1) = edgeBuffer[j].col(1); 
+			t.col(2) = point[i];
+			triTemp.push_back(std::move(t));
 		}
 	}
 	//[4]
-	for (int i = 0; i < triTemp.size(); i++) triAns.push_back(triTemp[i]);
+	for (int i = 0; i < triTemp.size(); i++) triAns.push_back(std::move(triTemp[i]));
 	for (int i = 0; i < triAns. size(); i++) {
-		Mat<> t;
 		for (int j = 0; j < 3; j++) {
-			triAns[i].getCol(j, t);
+			MatView<> t = triAns[i].col(j);
 			if (t[0]< minPoint[0] || t[1] < minPoint[1] || t[0] > maxPoint[0] || t[1] > maxPoint[1]) {
 				triAns.erase(triAns.begin() + i--); break;
 			}
 		}
 	}
 	// [Output]
+	arenaScope.end();													// 输出矩阵须在堆上
 	TrianglesNum = triAns.size();
 	Mat<>* Triangles = (Mat<>*)calloc(TrianglesNum, sizeof(Mat<>));
 	for (int i = 0; i < TrianglesNum; i++) Triangles[i] = triAns[i];
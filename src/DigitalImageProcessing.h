@@ -15,6 +15,10 @@ limitations under the License.
 #include "../../LiGu_AlgorithmLib/Mat.h"
 #include "../../LiGu_AlgorithmLib/BasicMachineLearning.h"
 #define PI 3.141592653589
+/*************************************************************************************************
+*	[精度]: 各函数以像素类型 T 模板化, 默认 double; 图像平面可用 Mat<float> 以减半内存带宽.
+*			核权值、归一化系数以 double 计算后再转为 T.
+*************************************************************************************************/
 namespace DigitalImageProcessing {
 /*************************************************************************************************
 *								基础操作
@@ -22,21 +26,21 @@ namespace DigitalImageProcessing {
 *	反相	:	所有颜色换成其补色				:	InvImage = 1 - Image
 *	转灰度图:	多通道(RGB)加权合并为灰度一通道	:	Gray = 0.3 R + 0.59 G + 0.11 B
 *************************************************************************************************/
-Mat<>& Binarization	(Mat<>& in, Mat<>& out, double threshold = 0.5) {
-	return out.zero(in).function(in, [&threshold](double x) { x > threshold ? 1.0 : 0.0; });
+template<class T = double>
+Mat<T>& Binarization(Mat<T>& in, Mat<T>& out, double threshold = 0.5) {
+	return out.map(in, [threshold](T x) { return x > threshold ? (T)1 : (T)0; });
 }
-Mat<>& Invert		(Mat<>& in, Mat<>& out) { return out.mul(-1, in); }
-Mat<>& Gray			(Mat<>* in, Mat<>& out, double Rk = 0.3, double Gk = 0.59, double Bk = 0.11) {
-	out.zero(in[0]);
-	Mat<> t;
-	out += t.mul(Rk / (Rk + Gk + Bk), in[0]);
-	out += t.mul(Gk / (Rk + Gk + Bk), in[1]);
-	out += t.mul(Bk / (Rk + Gk + Bk), in[2]);
-	return out;
+template<class T = double>
+Mat<T>& Invert		(Mat<T>& in, Mat<T>& out) { return out.mul(-1, in); }
+template<class T = double>
+Mat<T>& Gray		(Mat<T>* in, Mat<T>& out, double Rk = 0.3, double Gk = 0.59, double Bk = 0.11) {
+	double k = 1 / (Rk + Gk + Bk);
+	return out = in[0] * (T)(Rk * k) + in[1] * (T)(Gk * k) + in[2] * (T)(Bk * k);
 }
-Mat<>& Gray(Mat<>* in, Mat<>& out, double* rate, int N) {
+template<class T = double>
+Mat<T>& Gray(Mat<T>* in, Mat<T>& out, double* rate, int N) {
 	out.zero(in[0]);
-	Mat<> t;
+	Mat<T> t;
 	for (int i = 0; i < N; i++) out += t.mul(rate[i], in[i]);
 	return out;
 }
@@ -45,7 +49,8 @@ Mat<>& Gray(Mat<>* in, Mat<>& out, double* rate, int N) {
 *	[目的]: 简化聚类图像中的色彩.
 *	[算法]: K-Mean均值聚类
 *************************************************************************************************/
-Mat<>* ColorCluster(Mat<>* in, Mat<>* out, int K = 3, int TimesMax = 0x7FFFFFFF) {
+template<class T = double>
+Mat<T>* ColorCluster(Mat<T>* in, Mat<T>* out, int K = 3, int TimesMax = 0x7FFFFFFF) {
 	// Process in & out
 	Mat<> data(3, in[0].size());
 	for (int k = 0; k < 3; k++)
@@ -76,44 +81,56 @@ double SobelKernelTmp[] = {
 *	[目的]: 标识数字图像中亮度变化明显的点.
 *	[公式]: EdgeImage = Conv(Image , SobelKernel)
 *************************************************************************************************/
-Mat<>& EdgeDetection(Mat<>& in, Mat<>& out) {
-	Mat<> out_x, out_y;
-	out_x.conv(in, SobelKernel,                  1);
-	out_y.conv(in, SobelKernel.transpose(out_y), 1);
-	out.zero(in);
-	for (int i = 0; i < in.size(); i++)
-		out[i] = sqrt(out_x[i] * out_x[i] + out_y[i] * out_y[i]);
+template<class T = double>
+Mat<T>& EdgeDetection(Mat<T>& in, Mat<T>& out) {
+	Mat<T> kernel(3, 3), kernelT, out_x, out_y;
+	for (int i = 0; i < 9; i++) kernel[i] = SobelKernelTmp[i];
+	out_x.conv(in, kernel,                      1);
+	out_y.conv(in, kernel.transpose(kernelT),   1);
+	out.alloc(in.rows, in.cols);
+	T* __restrict o = out.data; const T* gx = out_x.data, * gy = out_y.data;
+	Parallel::parallelFor(in.size(), Mat<T>::PARALLEL_N, [=](int st, int ed) {
+		for (int i = st; i < ed; i++) o[i] = sqrt(gx[i] * gx[i] + gy[i] * gy[i]);
+	});
 	return out;
 }
 /*************************************************************************************************
 *								傅里叶变换
 *	[目的]: 转频域图像.
 *************************************************************************************************/
-Mat<>& FourierTransform(Mat<>& in, Mat<>& out) {
+template<class T = double>
+Mat<T>& FourierTransform(Mat<T>& in, Mat<T>& out) {
 	return out;
 }
-Mat<>& InvFourierTransform(Mat<>& in, Mat<>& out) {
+template<class T = double>
+Mat<T>& InvFourierTransform(Mat<T>& in, Mat<T>& out) {
 	return out;
 }
 /*************************************************************************************************
 *								Gauss 滤波
 * [输入]: in: 输入原图 out: 输出图像  size: 核的大小  sigma: 正态分布标准差
 *************************************************************************************************/
-Mat<>& GaussFilter(Mat<>& in, int size, float sigma, Mat<>& out) {
+template<class T = double>
+Mat<T>& GaussFilter(Mat<T>& in, int size, float sigma, Mat<T>& out) {
 	if (size <= 0 || sigma == 0) return out;
 	Mat<> GaussKernel(size, size);
 	for (int y = 0; y < size; y++)
 		for (int x = 0; x < size; x++)
 			GaussKernel(x, y) = 1 / (2 * PI * sigma * sigma) * exp(-(pow(x - size / 2, 2) + pow(y - size / 2, 2)) / (2 * sigma * sigma));
-	return out.conv(in, GaussKernel *= 1 / GaussKernel.sum(), 1);
+	GaussKernel *= 1 / GaussKernel.sum();
+	Mat<T> kernel(size, size);
+	for (int i = 0; i < kernel.size(); i++) kernel[i] = GaussKernel[i];
+	return out.conv(in, kernel, 1);
 }
 /*************************************************************************************************
 *								直方图
 * [目的]: 统计[0,255]亮度的像素个数分布.
 *************************************************************************************************/
-Mat<int>& Histograms(Mat<>& in, Mat<>& out) {
-	out.zero(0xFF);
+template<class T = double>
+Mat<int>& Histograms(Mat<T>& in, Mat<int>& out) {
+	out.zero(0x100);
 	for (int i = 0; i < in.size(); i++) out[(unsigned char)(in[i] * 0xFF)]++;
+	return out;
 }
 
 }
@@ -161,7 +161,8 @@ double PerlinNoise(double x, double y, Mat<>& randomGridGradient) {
 		ix1 = (n[3] - n[2]) * (3.0 - sx * 2.0) * sx * sx + n[2];
 	return (ix1 - ix0) * (3.0 - sy * 2.0) * sy * sy + ix0;
 }
-Mat<>& PerlinNoise(Mat<>& output, int frequency) {
+template<class T = double>
+Mat<T>& PerlinNoise(Mat<T>& output, int frequency) {
 	Mat<> randomGridGradient;
 	randomGridGradient.rands(frequency + 1, frequency + 1, 0, 256);
 	for (int y = 0; y < output.cols; y++)
@@ -176,10 +177,10 @@ Mat<>& PerlinNoise(Mat<>& output, int frequency) {
 /*************************************************************************************************
 *								三维分形树 Fractal Tree 3D
 *************************************************************************************************/
-void FractalTree3D(std::vector<Mat<>>& linesSt, std::vector<Mat<>>& linesEd, int level, double alpha, int fork = 3) {
+void FractalTree3D(std::vector<Mat<GraphicsND::real>>& linesSt, std::vector<Mat<GraphicsND::real>>& linesEd, int level, double alpha, int fork = 3) {
 	if (level <= 0) return;
 	// 确定旋转矩阵
-	Mat<> st = linesSt.back(), ed = linesEd.back(), direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
+	Mat<GraphicsND::real> st = linesSt.back(), ed = linesEd.back(), direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
 	direction.sub(ed, st);
 	if (direction[0] != 0 || direction[1] != 0) {
 		GraphicsND::rotate(
@@ -191,7 +192,7 @@ void FractalTree3D(std::vector<Mat<>>& linesSt, std::vector<Mat<>>& linesEd, int
 	else rotateMat.E(3);
 	//递归
 	double Lenth = direction.norm(); 
-	Mat<> endPoint(3);
+	Mat<GraphicsND::real> endPoint(3);
 	for (int i = 0; i < fork; i++) {
 		endPoint.set(
 			sin(alpha) * cos((double)i * 2 * PI / fork), 
@@ -467,7 +468,7 @@ int MarchingCubes_TriTable[256][16] = {
 	{0, 3, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
 	{-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1}
 };
-void MarchingCubes(Tensor<>& X, Mat<>& zero, Mat<>& dx, std::vector<Mat<>>& triangleSet, double isolevel = 0.5) {
+void MarchingCubes(Tensor<>& X, Mat<GraphicsND::real>& zero, Mat<GraphicsND::real>& dx, std::vector<Mat<GraphicsND::real>>& triangleSet, double isolevel = 0.5) {
 	static int 
 		Vertex[8] = { 0b0, 0b1, 0b11, 0b10, 0b100, 0b101,0b111, 0b110 },
 		Point[12][3]{
@@ -475,7 +476,7 @@ void MarchingCubes(Tensor<>& X, Mat<>& zero, Mat<>& dx, std::vector<Mat<>>& tria
 			{1, 0, 2}, {2, 1, 2}, {1, 2, 2}, {0, 1, 2},
 			{0, 0, 1}, {2, 0, 1}, {2, 2, 1}, {0, 2, 1}
 		};
-	Mat<> tri(3, 3);
+	Mat<GraphicsND::real> tri(3, 3);
 	for (int i = 0; i < X.size(); i++) {
 		int cubeindex = 0;
 		for (int j = 0; j < 8; j++) {
@@ -500,7 +501,7 @@ void MarchingCubes(Tensor<>& X, Mat<>& zero, Mat<>& dx, std::vector<Mat<>>& tria
 	}
 }
 template<typename F>
-void MarchingCubes(F& f, Mat<>& St, Mat<>& Ed, Mat<>& dx, std::vector<Mat<>>& triangleSet, double isolevel = 0.5) {
+void MarchingCubes(F& f, Mat<GraphicsND::real>& St, Mat<GraphicsND::real>& Ed, Mat<GraphicsND::real>& dx, std::vector<Mat<GraphicsND::real>>& triangleSet, double isolevel = 0.5) {
 	static int 
 		Vertex[8] = { 0b0, 0b1, 0b11, 0b10, 0b100, 0b101,0b111, 0b110 },
 		Point[12][3]{
@@ -508,7 +509,7 @@ void MarchingCubes(F& f, Mat<>& St, Mat<>& Ed, Mat<>& dx, std::vector<Mat<>>& tr
 			{1, 0, 2}, {2, 1, 2}, {1, 2, 2}, {0, 1, 2},
 			{0, 0, 1}, {2, 0, 1}, {2, 2, 1}, {0, 2, 1}
 		};
-	Mat<> tri(3, 3), vec(3), tmp; tmp.sub(Ed, St).elementDiv(dx);
+	Mat<GraphicsND::real> tri(3, 3), vec(3), tmp; tmp.sub(Ed, St).elementDiv(dx);
 	Mat<int> delta(3); delta.set(tmp[0], tmp[1], tmp[2]);
 	int n = delta.product();
 	for (int i = 0; i < n; i++) {
@@ -565,11 +566,11 @@ struct BoidsBird { Mat<> r{ 3 }, v{ 3 }, a{ 3 }; };
 void BoidsRule(std::vector<BoidsBird>& birds, int index, 
 	double visualField, double visualAngle, double* weight, void(*obstacleAvoidance)(BoidsBird& birds)
 ) {
-	Mat<> distance(3), avoidDirection(3), groupVelocity(3), groupCenter(3), tmp;
+	Vec3 distance, avoidDirection, groupVelocity, groupCenter, tmp;
 	int groupNum = 0;
 	for (int i = 0; i < birds.size(); i++) {
 		if ( i == index
-		|| distance.add(birds[i].r,birds[index].r.negative(distance)).norm()                   > visualField
+		|| distance.sub(birds[i].r, birds[index].r).norm()                                     > visualField
 		|| distance.dot(distance,  birds[index].v) / (distance.norm() * birds[index].v.norm()) < visualAngle
 		) continue;
 		groupNum++;
@@ -591,7 +592,7 @@ void Boids(std::vector<BoidsBird>& birds, void(*obstacleAvoidance)(BoidsBird& bi
 	double visualField, double visualAngle, double* weight, double dt = 1, double speed = 3 // 能见范围、能见角度cos、各规则权值
 ) {
 	for (int i = 0; i < birds.size(); i++) BoidsRule(birds, i, visualField, visualAngle, weight, obstacleAvoidance);
-	Mat<> tmp(3);
+	Vec3 tmp;
 	for (int i = 0; i < birds.size(); i++) {
 		birds[i].v += (tmp.mul(dt,         birds[i].a));
 		birds[i].r += (tmp.mul(dt * speed, birds[i].v.normalize()));
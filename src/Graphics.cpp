@@ -11,6 +11,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include "Graphics.h"
+#include <vector>
+#include <algorithm>
+#ifndef PI
+#define PI 3.141592653589
+#endif
+#define MITER_LIMIT 4.0													//斜接比上限, 超过时退化为斜切
 /******************************************************************************
 
 *                    Basic Function
@@ -18,32 +24,80 @@ limitations under the License.
 ******************************************************************************/
 /*----------------[ INIT ]----------------*/
 void Graphics::init(INT32S width, INT32S height) {
-	Canvas.zero(height, width); TransMat.E(3);
+	Canvas.zero(height, width); TransMat.E(3); updateTrans();
+	DirtyTile.zero((height + TILE - 1) >> TILE_BIT, (width + TILE - 1) >> TILE_BIT);
+	ClearColor = TRANSPARENT;
+	markDirty();
 }
-/*----------------[ CLEAR ]----------------*/
+/*----------------[ CLEAR ]----------------
+*	忽略透明度, 按行段写入.
+*	颜色与上次清屏相同时, 只重写上次清屏后画过 (DRAWN) 的瓦片, 其余瓦片仍为该颜色.
+** ---------------------------------------- */
 void Graphics::clear(ARGB color)
 {
-	if (color == TRANSPARENT || color == 0) {	//memset按字节处理，故只能处理高低字节相同的值
-		memset(Canvas.data, color, sizeof(RGB) * Canvas.size()); return;
+	color &= 0xFFFFFF;
+	if (color != ClearColor) {
+		fillPixels(Canvas.data, Canvas.size(), color);
+		ClearColor = color;
+		for (int i = 0; i < DirtyTile.size(); i++) DirtyTile[i] = DIRTY;
+		return;
+	}
+	for (INT32S tx = 0; tx < DirtyTile.rows; tx++) {
+		INT32S sx = tx << TILE_BIT, ex = sx + TILE < Canvas.rows ? sx + TILE : Canvas.rows;
+		for (INT32S ty = 0; ty < DirtyTile.cols; ty++) {
+			if (!(DirtyTile(tx, ty) & DRAWN)) continue;
+			INT32S tyEnd = ty;											//连续瓦片合为一段
+			while (tyEnd + 1 < DirtyTile.cols && (DirtyTile(tx, tyEnd + 1) & DRAWN)) tyEnd++;
+			INT32S sy = ty << TILE_BIT, ey = ((tyEnd + 1) << TILE_BIT) < Canvas.cols ? ((tyEnd + 1) << TILE_BIT) : Canvas.cols;
+			for (INT32S x = sx; x < ex; x++) fillPixels(&Canvas(x, sy), ey - sy, color);
+			for (; ty <= tyEnd; ty++) DirtyTile(tx, ty) = DIRTY;
+		}
 	}
-	for (INT32S y = 0; y < Canvas.cols; y++)
-		for (INT32S x = 0; x < Canvas.rows; x++)
-			Canvas(x, y) = color;
 }
 /*----------------[ SET/READ POINT ]---------------- 
 *	AlphaBlend 算法,	8位ARGB色彩
+*	dst = (a·dst + (255 - a)·src) / 255, a 为透明度 (0: 不透明, 0xFF: 全透明), 8 位定点, 四舍五入.
+*	变换为整数平移 (含恒等) 时只加平移量, 不做矩阵乘法.
 ** ---------------------------------------- */
+static inline unsigned int div255(unsigned int x) { x += 0x80; return (x + (x >> 8)) >> 8; }	//x / 255 四舍五入, x <= 255²
+static inline void blendPixel(RGB& dst, ARGB color) {
+	unsigned int a = color >> 24, ia = 0xFF - a;
+	if (a == 0) { dst.R = color >> 16; dst.G = color >> 8; dst.B = color; return; }
+	if (a == 0xFF) return;
+	dst.R = div255(a * dst.R + ia * (INT8U)(color >> 16));
+	dst.G = div255(a * dst.G + ia * (INT8U)(color >> 8));
+	dst.B = div255(a * dst.B + ia * (INT8U)color);
+}
 void Graphics::setPoint(INT32S x, INT32S y,ARGB color) {
-	INT32S xt = TransMat(0, 0) * x + TransMat(0, 1) * y + TransMat(0, 2),
-	       yt = TransMat(1, 0) * x + TransMat(1, 1) * y + TransMat(1, 2);
-	x = xt; 
-	y = yt;
-	if (judgeOutRange(x, y))return;
-	double alpha = (color >> 24) / 255.0;
-	unsigned char R = color >> 16, G = color >> 8, B = color;
-	Canvas(x, y).R = alpha * Canvas(x, y).R + (1 - alpha) * R;
-	Canvas(x, y).G = alpha * Canvas(x, y).G + (1 - alpha) * G;
-	Canvas(x, y).B = alpha * Canvas(x, y).B + (1 - alpha) * B;
+	if (TransIsInt) { x += TransDx; y += TransDy; }
+	else {
+		INT32S xt = TransMat(0, 0) * x + TransMat(0, 1) * y + TransMat(0, 2),
+		       yt = TransMat(1, 0) * x + TransMat(1, 1) * y + TransMat(1, 2);
+		x = xt; 
+		y = yt;
+	}
+	if ((INT32U)x >= (INT32U)Canvas.rows || (INT32U)y >= (INT32U)Canvas.cols) return;
+	blendPixel(Canvas(x, y), color);
+	markTile(x, y);
+}
+/*----------------[ 批量画点 ]----------------
+*	变换类型只判断一次; color == NULL 时全部使用 PaintColor.
+** ---------------------------------------- */
+void Graphics::setPoints(const INT32S x[], const INT32S y[], const ARGB color[], INT32S n) {
+	INT32U rows = Canvas.rows, cols = Canvas.cols;
+	FP64 m00 = TransMat(0, 0), m01 = TransMat(0, 1), m02 = TransMat(0, 2),
+	     m10 = TransMat(1, 0), m11 = TransMat(1, 1), m12 = TransMat(1, 2);
+	for (INT32S i = 0; i < n; i++) {
+		INT32S xt, yt;
+		if (TransIsInt) { xt = x[i] + TransDx; yt = y[i] + TransDy; }
+		else {
+			xt = m00 * x[i] + m01 * y[i] + m02;
+			yt = m10 * x[i] + m11 * y[i] + m12;
+		}
+		if ((INT32U)xt >= rows || (INT32U)yt >= cols) continue;
+		blendPixel(Canvas(xt, yt), color == NULL ? PaintColor : color[i]);
+		markTile(xt, yt);
+	}
 }
 ARGB Graphics::readPoint(INT32S x, INT32S y) {
 	if (judgeOutRange(x, y))return TRANSPARENT;
@@ -51,6 +105,69 @@ ARGB Graphics::readPoint(INT32S x, INT32S y) {
 		 + Canvas(x, y).G * 0x100 
 		 + Canvas(x, y).B;
 }
+/*----------------[ SPAN ]----------------
+*	行段: 画布第 x 行 (Canvas 第一维) 的 [sy, ey] 列, 内存连续.
+*	先裁剪一次, 再整段处理:
+*		不透明 (alpha == 0)   : 以 16 像素 (48 字节) 图案块整体写入, 编译为向量存储.
+*		半透明               : 8 位定点混合 dst = (a·dst + (255 - a)·src) / 255, 逐字节, 可向量化.
+*		全透明 (alpha == 0xFF): 不写.
+** ---------------------------------------- */
+void Graphics::fillPixels(RGB* dst, INT32S n, ARGB color) {
+	INT32U a = color >> 24, ia = 0xFF - a;
+	if (n <= 0 || a == 0xFF) return;
+	enum { BLOCK = 16, BYTES = BLOCK * 3 };
+	INT8U pattern[BYTES];
+	for (int i = 0; i < BLOCK; i++) {
+		pattern[3 * i + 0] = color >> 16;
+		pattern[3 * i + 1] = color >> 8;
+		pattern[3 * i + 2] = color;
+	}
+	INT8U* d = (INT8U*)dst;
+	INT32S bytes = n * 3, i = 0;
+	if (a == 0) {
+		for (; i + BYTES <= bytes; i += BYTES) memcpy(d + i, pattern, BYTES);
+		memcpy(d + i, pattern, bytes - i);
+		return;
+	}
+	for (; i + BYTES <= bytes; i += BYTES)
+		for (int k = 0; k < BYTES; k++) d[i + k] = div255(a * d[i + k] + ia * pattern[k]);
+	for (int k = 0; i + k < bytes; k++) d[i + k] = div255(a * d[i + k] + ia * pattern[k]);
+}
+void Graphics::fillSpan(INT32S x, INT32S sy, INT32S ey, ARGB color) {
+	if (sy > ey) { INT32S t = ey; ey = sy, sy = t; }
+	if (x < 0 || x >= Canvas.rows) return;
+	sy = sy < 0 ? 0 : sy;
+	ey = ey < Canvas.cols ? ey : Canvas.cols - 1;
+	if (sy > ey) return;
+	fillPixels(&Canvas(x, sy), ey - sy + 1, color);
+	INT8U* tile = &DirtyTile(x >> TILE_BIT, 0);
+	for (INT32S ty = sy >> TILE_BIT; ty <= ey >> TILE_BIT; ty++) tile[ty] = DIRTY | DRAWN;
+}
+void Graphics::copySpan(INT32S x, INT32S y, const RGB* src, INT32S n) {
+	if (x < 0 || x >= Canvas.rows) return;
+	if (y < 0) { src -= y; n += y; y = 0; }
+	if (y + n > Canvas.cols) n = Canvas.cols - y;
+	if (n <= 0) return;
+	memcpy(&Canvas(x, y), src, sizeof(RGB) * n);
+	INT8U* tile = &DirtyTile(x >> TILE_BIT, 0);
+	for (INT32S ty = y >> TILE_BIT; ty <= (y + n - 1) >> TILE_BIT; ty++) tile[ty] = DIRTY | DRAWN;
+}
+/*----------------[ 变换是否为整数平移 ]----------------
+*	是则行段可整体平移后填充, 否则调用者逐点 setPoint.
+*	结果由 updateTrans 缓存, 变换函数 (translate/rotate/scale) 修改 TransMat 后自动更新.
+** ---------------------------------------- */
+bool Graphics::isTranslate(INT32S& dx, INT32S& dy) {
+	dx = TransDx;
+	dy = TransDy;
+	return TransIsInt;
+}
+void Graphics::updateTrans() {
+	TransDx = TransMat(0, 2);
+	TransDy = TransMat(1, 2);
+	TransIsInt = TransMat(0, 0) == 1 && TransMat(0, 1) == 0
+	          && TransMat(1, 0) == 0 && TransMat(1, 1) == 1
+	          && TransDx == TransMat(0, 2) && TransDy == TransMat(1, 2);
+}
 /*----------------[ 存图 ]----------------*/
 void Graphics::writeImg(const char* filename) {
 	FILE* fp = fopen(filename, "wb");
@@ -62,22 +179,102 @@ void Graphics::writeImg(const char* filename) {
 bool Graphics::judgeOutRange(INT32S x0, INT32S y0){
 	return (x0 < 0 || x0 >= Canvas.rows) || (y0 < 0 || y0 >= Canvas.cols) ? true : false;
 }
-/*----------------[ 全图变换 ]----------------*/
-void Graphics::transSelf() {
-	Mat<RGB> tmp(Canvas.rows, Canvas.cols);
-	for (INT32S y = 0; y < Canvas.rows; y++) {
-		for (INT32S x = 0; x < Canvas.cols; x++) {
-			 INT32S xt = TransMat(0, 0) * x + TransMat(0, 1) * y + TransMat(0, 2);
-			 INT32S yt = TransMat(1, 0) * x + TransMat(1, 1) * y + TransMat(1, 2);
-			 if (judgeOutRange(xt, yt))continue;
-			 memcpy(tmp.data + yt * Canvas.cols + xt, Canvas.data + y * Canvas.rows + x, sizeof(RGB));
-			 // 反走样
-			 if (judgeOutRange(xt + 1, yt + 1))continue;
-			 memcpy(tmp.data + (yt + 1) * Canvas.cols + xt, Canvas.data + y * Canvas.cols + x, sizeof(RGB));
-			 memcpy(tmp.data + yt * Canvas.cols + (xt + 1), Canvas.data + y * Canvas.cols + x, sizeof(RGB));
-			 memcpy(tmp.data + (yt + 1) * Canvas.cols + (xt + 1), Canvas.data + y * Canvas.cols + x, sizeof(RGB));
+/*----------------[ 全图变换 ]----------------
+*	[逆映射]: 对目标像素 (X, Y) 求源坐标 (u, v) = A⁻¹·((X, Y) - t), 按插值方式采样, 每个目标像素恰好写一次, 无空洞.
+*		同一行内 (u, v) 随 Y 线性变化, 逐像素只做两次加法 (du = A⁻¹(0,1), dv = A⁻¹(1,1)); 行首直接计算, 误差不跨行累积.
+*		行内落在源图内的区间 [Ys, Ye] 事先解出, 区间外直接置零, 区间内不做越界判断.
+*	[插值]: INTERP_NEAREST 最近邻; INTERP_BILINEAR 双线性 (8 位定点权重); INTERP_BICUBIC 双三次 (Catmull-Rom),
+*		邻点越界时取边缘像素.
+*	[并行]: 各行互不相关, 按行并行.
+** ---------------------------------------- */
+static inline const RGB& clampPix(const Mat<RGB>& src, int x, int y) {
+	x = x < 0 ? 0 : (x >= src.rows ? src.rows - 1 : x);
+	y = y < 0 ? 0 : (y >= src.cols ? src.cols - 1 : y);
+	return src.data[x * src.cols + y];
+}
+static inline void cubicWeight(double t, double w[4]) {				//Catmull-Rom, 采样点 -1, 0, 1, 2
+	double t2 = t * t, t3 = t2 * t;
+	w[0] = -0.5 * t3 + t2 - 0.5 * t;
+	w[1] =  1.5 * t3 - 2.5 * t2 + 1;
+	w[2] = -1.5 * t3 + 2 * t2 + 0.5 * t;
+	w[3] =  0.5 * t3 - 0.5 * t2;
+}
+void Graphics::transSelf(INT32S interp) {
+	FP64 a = TransMat(0, 0), b = TransMat(0, 1), c = TransMat(1, 0), d = TransMat(1, 1),
+		 det = a * d - b * c;
+	Mat<RGB> src; src.eatMat(Canvas);
+	Canvas.zero(src.rows, src.cols);
+	markDirty();
+	if (det == 0) return;
+	FP64 ia = d / det, ib = -b / det, ic = -c / det, id = a / det,		//A⁻¹
+		 tx = TransMat(0, 2), ty = TransMat(1, 2);
+	//------ 源坐标合法范围: 最近邻按四舍五入, 插值按左上邻点 ------
+	FP64 uLo = interp == INTERP_NEAREST ? -0.5 : 0, uHi = interp == INTERP_NEAREST ? src.rows - 0.5 : src.rows - 1,
+		 vLo = interp == INTERP_NEAREST ? -0.5 : 0, vHi = interp == INTERP_NEAREST ? src.cols - 0.5 : src.cols - 1;
+	const INT32S rows = Canvas.rows, cols = Canvas.cols;
+	Parallel::parallelFor(rows, (1 << 14) / (cols + 1) + 1, [&](int st, int ed) {
+		for (INT32S X = st; X < ed; X++) {
+			FP64 u = ia * (X - tx) - ib * ty, v = ic * (X - tx) - id * ty;	//Y = 0 处源坐标
+			//------ 求 Y 区间, 使 u + ib·Y ∈ [uLo, uHi], v + id·Y ∈ [vLo, vHi] ------
+			FP64 ys = 0, ye = cols - 1;
+			auto limit = [&ys, &ye](FP64 p0, FP64 dp, FP64 lo, FP64 hi) {
+				if (dp == 0) { if (p0 < lo || p0 > hi) ye = -1; return; }
+				FP64 y1 = (lo - p0) / dp, y2 = (hi - p0) / dp;
+				if (y1 > y2) std::swap(y1, y2);
+				ys = ys > y1 ? ys : y1;
+				ye = ye < y2 ? ye : y2;
+			};
+			limit(u, ib, uLo, uHi);
+			limit(v, id, vLo, vHi);
+			INT32S Ys = ceil(ys), Ye = floor(ye);
+			RGB* row = &Canvas(X, 0);
+			if (Ys > Ye) continue;
+			u += ib * Ys; v += id * Ys;
+			switch (interp) {
+			case INTERP_NEAREST:
+				for (INT32S Y = Ys; Y <= Ye; Y++, u += ib, v += id)
+					row[Y] = clampPix(src, (INT32S)(u + 0.5), (INT32S)(v + 0.5));		//u, v >= -0.5, 截断即四舍五入
+				break;
+			case INTERP_BILINEAR:
+				for (INT32S Y = Ys; Y <= Ye; Y++, u += ib, v += id) {
+					INT32S x0 = u, y0 = v,									//u, v >= 0, 截断即 floor
+						   x1 = x0 + 1 < src.rows ? x0 + 1 : x0,
+						   y1 = y0 + 1 < src.cols ? y0 + 1 : y0,
+						   fu = (u - x0) * 256 + 0.5, fv = (v - y0) * 256 + 0.5;
+					fu = fu > 256 ? 256 : fu; fv = fv > 256 ? 256 : fv;
+					const INT8U* p00 = (const INT8U*)&src(x0, y0), * p01 = (const INT8U*)&src(x0, y1),
+							   * p10 = (const INT8U*)&src(x1, y0), * p11 = (const INT8U*)&src(x1, y1);
+					INT8U* q = (INT8U*)&row[Y];
+					for (int k = 0; k < 3; k++) {
+						INT32S t0 = p00[k] * (256 - fv) + p01[k] * fv,
+							   t1 = p10[k] * (256 - fv) + p11[k] * fv;
+						q[k] = (t0 * (256 - fu) + t1 * fu + (1 << 15)) >> 16;
+					}
+				}
+				break;
+			case INTERP_BICUBIC:
+				for (INT32S Y = Ys; Y <= Ye; Y++, u += ib, v += id) {
+					INT32S x0 = u, y0 = v;
+					FP64 wu[4], wv[4], sum[3] = { 0 };
+					cubicWeight(u - x0, wu);
+					cubicWeight(v - y0, wv);
+					bool isInner = x0 >= 1 && x0 + 2 < src.rows && y0 >= 1 && y0 + 2 < src.cols;	//内部: 4x4 邻域不越界, 免逐点钳位
+					for (int i = 0; i < 4; i++) {
+						FP64 r[3] = { 0 };
+						const INT8U* p = isInner ? (const INT8U*)&src(x0 - 1 + i, y0 - 1) : NULL;
+						for (int j = 0; j < 4; j++, p += isInner ? 3 : 0) {
+							const INT8U* q = isInner ? p : (const INT8U*)&clampPix(src, x0 - 1 + i, y0 - 1 + j);
+							r[0] += wv[j] * q[0]; r[1] += wv[j] * q[1]; r[2] += wv[j] * q[2];
+						}
+						for (int k = 0; k < 3; k++) sum[k] += wu[i] * r[k];
+					}
+					INT8U* q = (INT8U*)&row[Y];
+					for (int k = 0; k < 3; k++) q[k] = sum[k] < 0 ? 0 : (sum[k] > 255 ? 255 : (INT8U)(sum[k] + 0.5));
+				}
+				break;
+			}
 		}
-	} Canvas.eatMat(tmp);
+	});
 }
 /*----------------[ 剪切图 ]----------------*/
 void Graphics::CutSelf(INT32S sx, INT32S sy, INT32S ex, INT32S ey) {
@@ -87,6 +284,79 @@ void Graphics::CutSelf(INT32S sx, INT32S sy, INT32S ex, INT32S ey) {
 	for (int y = 0; y < ey - sy; y++)
 		memcpy(tmp.data + y * width, Canvas.data + (sy + y) * Canvas.cols + sx, sizeof(RGB) * width);
 	Canvas.eatMat(tmp);
+	DirtyTile.zero((Canvas.rows + TILE - 1) >> TILE_BIT, (Canvas.cols + TILE - 1) >> TILE_BIT);
+	ClearColor = TRANSPARENT;
+	markDirty();
+}
+/******************************************************************************
+
+*                    脏区 (瓦片)
+*	[目的]: 动画每帧 clear 后重画, 再整幅输出; 实际改变的往往只是画面一小部分.
+*	[方法]: 画布按 TILE x TILE 分为瓦片, 每块一个字节的标记:
+*		DIRTY: 上次 resetDirty 后改变过, 供输出 (writeImgDirty, getDirtyRects) 只处理这些瓦片;
+*		DRAWN: 上次 clear 后画过, 供 clear 只重写这些瓦片.
+*		setPoint/setPoints/fillSpan/copySpan 自动标记; 直接写 Canvas (如 Composite::blend) 后需调用 markDirty.
+
+******************************************************************************/
+void Graphics::markDirty(INT32S sx, INT32S sy, INT32S ex, INT32S ey) {
+	if (sx > ex) { INT32S t = ex; ex = sx, sx = t; }
+	if (sy > ey) { INT32S t = ey; ey = sy, sy = t; }
+	sx = sx > 0 ? sx : 0; ex = ex < Canvas.rows ? ex : Canvas.rows - 1;
+	sy = sy > 0 ? sy : 0; ey = ey < Canvas.cols ? ey : Canvas.cols - 1;
+	for (INT32S tx = sx >> TILE_BIT; tx <= ex >> TILE_BIT; tx++)
+		for (INT32S ty = sy >> TILE_BIT; ty <= ey >> TILE_BIT; ty++)
+			DirtyTile(tx, ty) = DIRTY | DRAWN;
+}
+void Graphics::markDirty() {
+	for (int i = 0; i < DirtyTile.size(); i++) DirtyTile[i] = DIRTY | DRAWN;
+}
+void Graphics::resetDirty() {
+	for (int i = 0; i < DirtyTile.size(); i++) DirtyTile[i] &= ~DIRTY;
+}
+/*----------------[ 脏区矩形 ]----------------
+*	每行瓦片中连续的脏瓦片合为一个矩形 {sx, sy, ex, ey} (画布坐标, 闭区间), 依次存入 rects.
+** ---------------------------------------- */
+Graphics::INT32S Graphics::getDirtyRects(std::vector<INT32S>& rects) {
+	rects.clear();
+	for (INT32S tx = 0; tx < DirtyTile.rows; tx++)
+		for (INT32S ty = 0; ty < DirtyTile.cols; ty++) {
+			if (!(DirtyTile(tx, ty) & DIRTY)) continue;
+			INT32S tyEnd = ty;
+			while (tyEnd + 1 < DirtyTile.cols && (DirtyTile(tx, tyEnd + 1) & DIRTY)) tyEnd++;
+			INT32S ex = ((tx + 1) << TILE_BIT) - 1, ey = ((tyEnd + 1) << TILE_BIT) - 1;
+			rects.push_back(tx << TILE_BIT);
+			rects.push_back(ty << TILE_BIT);
+			rects.push_back(ex < Canvas.rows ? ex : Canvas.rows - 1);
+			rects.push_back(ey < Canvas.cols ? ey : Canvas.cols - 1);
+			ty = tyEnd;
+		}
+	return rects.size() / 4;
+}
+/*----------------[ 存图 (只改写脏区) ]----------------
+*	文件已存在且头部 (格式、宽高) 一致时, 以 "r+b" 打开, 按脏区矩形逐行定位改写; 否则整幅写入.
+*	完成后清空脏区.
+** ---------------------------------------- */
+void Graphics::writeImgDirty(const char* filename) {
+	char head[64], headOld[64];
+	INT32S headLen = sprintf(head, "P6\n%d %d\n255\n", Canvas.cols, Canvas.rows);
+	FILE* fp = fopen(filename, "r+b");
+	if (fp == NULL || fread(headOld, 1, headLen, fp) != (size_t)headLen || memcmp(head, headOld, headLen) != 0) {
+		if (fp != NULL) fclose(fp);
+		writeImg(filename);
+		resetDirty();
+		return;
+	}
+	std::vector<INT32S> rects;
+	INT32S n = getDirtyRects(rects);
+	for (INT32S i = 0; i < n; i++) {
+		INT32S* r = &rects[i * 4];
+		for (INT32S x = r[0]; x <= r[2]; x++) {
+			fseek(fp, headLen + ((long)x * Canvas.cols + r[1]) * 3, SEEK_SET);
+			fwrite(&Canvas(x, r[1]), 3, r[3] - r[1] + 1, fp);
+		}
+	}
+	fclose(fp);
+	resetDirty();
 }
 /******************************************************************************
 
@@ -96,22 +366,8 @@ void Graphics::CutSelf(INT32S sx, INT32S sy, INT32S ex, INT32S ey) {
 /*----------------[ DRAW POINT ]----------------*/
 void Graphics::drawPoint(INT32S x0, INT32S y0) {
 	if (judgeOutRange(x0, y0))return;
-	setPoint(x0, y0, PaintColor);										//基础点(点粗==0)
-	/*------ 点粗>0时 ------*/
-	if (PaintSize > 0) {
-		INT32S x = 0, y = PaintSize, p = 3 - (PaintSize << 1);			//初始点:天顶(0,r)//p:决策参数(r右移即乘2)
-		INT32S x_step[] = { 1,1,-1,-1 }, 
-			   y_step[] = { 1,-1,1,-1 };		//上下左右对称四个点
-		/*------ 绘制圆 (x=0始,y=x终) ------*/
-		while (x <= y) {
-			for (int i = x0 - x; i <= x0 + x; i++) { setPoint(i, y0 - y, PaintColor); setPoint(i, y0 + y, PaintColor); }	//填充圆内
-			for (int i = x0 - y; i <= x0 + y; i++) { setPoint(i, y0 - x, PaintColor); setPoint(i, y0 + x, PaintColor); }
-			x++;
-			INT32S dp = 4 * x + 6;
-			if (p < 0)p += dp;
-			else { p += dp - 4 * y + 4; y--; }							//p过临界值，y加一
-		}
-	}
+	if (PaintSize > 0) fillCircle(x0, y0, PaintSize);					//点粗>0时: 实心圆
+	else setPoint(x0, y0, PaintColor);									//基础点(点粗==0)
 }
 /*----------------[ DRAW LINE ]---------------- 
 *	Bresenham Algorithm		
@@ -120,6 +376,11 @@ void Graphics::drawPoint(INT32S x0, INT32S y0) {
 		2. 各方向均可绘制
 ** ---------------------------------------- */
 void Graphics::drawLine(INT32S x1, INT32S y1, INT32S x2, INT32S y2) {
+	if (PaintSize > 0) {												//粗线: 圆头描边, 不再逐步画圆
+		FP64 xs[] = { (FP64)x1, (FP64)x2 }, ys[] = { (FP64)y1, (FP64)y2 };
+		drawPolyline(xs, ys, 2, 2 * PaintSize + 1, JOIN_ROUND, CAP_ROUND);
+		return;
+	}
 	INT32S err[2] = { 0 }, 
 		   inc[2] = { 0 }, 
 		   delta[2] = { x2 - x1, y2 - y1 },
@@ -145,6 +406,11 @@ void Graphics::drawLine(INT32S x1, INT32S y1, INT32S x2, INT32S y2) {
 /*----------------[ DRAW TRIANGLE ]----------------*/
 void Graphics::drawPolygon(INT32S x[], INT32S y[], INT32S n)
 {
+	if (PaintSize > 0) {												//粗线: 闭合折线描边, 每像素只填一次
+		std::vector<FP64> xs(x, x + n), ys(y, y + n);
+		drawPolyline(xs.data(), ys.data(), n, 2 * PaintSize + 1, JOIN_ROUND, CAP_ROUND, true);
+		return;
+	}
 	for (int i = 0; i < n; i++) 
 		drawLine(x[i], y[i], x[(i + 1) % n], y[(i + 1) % n]);
 }
@@ -153,6 +419,11 @@ void Graphics::drawPolygon(INT32S x[], INT32S y[], INT32S n)
 //(x1,y1),(x2,y2):矩形的对角坐标
 void Graphics::drawRectangle(INT32S x1, INT32S y1, INT32S x2, INT32S y2)
 {
+	if (PaintSize > 0) {
+		FP64 xs[] = { (FP64)x1, (FP64)x2, (FP64)x2, (FP64)x1 }, ys[] = { (FP64)y1, (FP64)y1, (FP64)y2, (FP64)y2 };
+		drawPolyline(xs, ys, 4, 2 * PaintSize + 1, JOIN_MITER, CAP_BUTT, true);
+		return;
+	}
 	drawLine(x1, y1, x2, y1);
 	drawLine(x1, y1, x1, y2);
 	drawLine(x1, y2, x2, y2);
@@ -257,70 +528,319 @@ void Graphics::drawWave(INT32S x[], INT32S y[], INT32S n) {
 		yt = y[i];	
 	}
 }
-/*----------------[ DRAW BEZIER CURVE ]----------------*/
+/*----------------[ DRAW BEZIER CURVE ]----------------
+*	de Casteljau 自适应细分 (bezierAdaptive) 为折线, 再逐段画线; 粗线整条交给 drawPolyline.
+*	容差取 0.5 像素, 按变换矩阵线性部分的 Frobenius 范数换算到变换前坐标 (|A·v| <= |A|_F·|v|).
+** ---------------------------------------- */
 void Graphics::drawBezier(INT32S xCtrl[], INT32S yCtrl[], INT32S n)
 {
-	INT32S N = Canvas.rows + Canvas.cols;					//#待优化
-	FP64 C[50];
-	for (INT32S i = 0; i < n; i++) 
-		setPoint(xCtrl[i], yCtrl[i],0xFFFFFF);
+	if (n <= 0) return;
+	std::vector<FP64> p(2 * n), xs, ys;
 	for (INT32S i = 0; i < n; i++) {
-		C[i] = 1;
-		for (INT32S j = n - 1; j >= i + 1; j--) C[i] *= j;
-		for (INT32S j = n - 1 - i; j >= 2; j--) C[i] /= j;
+		setPoint(xCtrl[i], yCtrl[i], 0xFFFFFF);
+		p[2 * i] = xCtrl[i]; p[2 * i + 1] = yCtrl[i];
 	}
-	for (INT32S k = 0; k < N; k++) {
-		FP64 u = (FP64)k / N;
-		INT32S x = 0, y = 0;
-		for (INT32S i = 0; i < n; i++) {
-			FP64 bezBlendFcn = C[i] * pow(u, i) * pow(1 - u, n - 1 - i);
-			x += xCtrl[i] * bezBlendFcn;
-			y += yCtrl[i] * bezBlendFcn;
+	FP64 norm = sqrt(TransMat(0, 0) * TransMat(0, 0) + TransMat(0, 1) * TransMat(0, 1)
+				   + TransMat(1, 0) * TransMat(1, 0) + TransMat(1, 1) * TransMat(1, 1));
+	bezierAdaptive(p.data(), n, 2, norm > 0 ? 0.5 / norm : 0.5, [&](const FP64* q) { xs.push_back(q[0]); ys.push_back(q[1]); });
+	INT32S ptNum = xs.size();
+	if (PaintSize > 0) { drawPolyline(xs.data(), ys.data(), ptNum, 2 * PaintSize + 1); return; }
+	INT32S xPre = round(xs[0]), yPre = round(ys[0]);
+	if (ptNum == 1) drawPoint(xPre, yPre);
+	for (INT32S i = 1; i < ptNum; i++) {
+		INT32S x = round(xs[i]), y = round(ys[i]);
+		if (x == xPre && y == yPre) continue;
+		drawLine(xPre, yPre, x, y);
+		xPre = x; yPre = y;
+	}
+}
+/*----------------[ 反走样 (Anti-Aliasing) ]----------------
+*	不再超采样: 直接按像素覆盖率 coverage ∈ [0, 1] 混合画笔颜色,
+*	透明度 = 255 - (255 - 画笔透明度)·coverage, 经 blendPixel 写入 (8 位定点).
+*	[直线]: Wu 算法 (lineWu), 端点为浮点, 可亚像素定位.
+*	[圆]: 分四段, 沿主轴逐像素求精确交点 x0 ± sqrt(r² - dy²), 覆盖率分给两侧像素.
+*	[贝塞尔]: bezierForward 按控制多边形长度定段数 (约 2 像素一段), 前向差分求点, 每段 Wu 直线.
+*	坐标先经 TransMat 变换 (浮点) 再光栅化; 圆的半径乘以 sqrt|det|, 仅对相似变换准确.
+** ---------------------------------------- */
+void Graphics::plotAA(INT32S x, INT32S y, FP64 coverage) {
+	if ((INT32U)x >= (INT32U)Canvas.rows || (INT32U)y >= (INT32U)Canvas.cols || coverage <= 0) return;
+	INT32U a = 0xFF - (INT32U)((0xFF - (PaintColor >> 24)) * (coverage < 1 ? coverage : 1) + 0.5);
+	blendPixel(Canvas(x, y), (PaintColor & 0xFFFFFF) | a << 24);
+	markTile(x, y);
+}
+void Graphics::transPoint(FP64& x, FP64& y) {
+	if (TransIsInt) { x += TransDx; y += TransDy; return; }
+	FP64 xt = TransMat(0, 0) * x + TransMat(0, 1) * y + TransMat(0, 2),
+		 yt = TransMat(1, 0) * x + TransMat(1, 1) * y + TransMat(1, 2);
+	x = xt;
+	y = yt;
+}
+void Graphics::drawLineAA(FP64 x1, FP64 y1, FP64 x2, FP64 y2) {
+	transPoint(x1, y1);
+	transPoint(x2, y2);
+	lineWu(x1, y1, x2, y2, Canvas.rows, Canvas.cols, [this](INT32S x, INT32S y, FP64 c, FP64) { plotAA(x, y, c); });
+}
+void Graphics::drawCircleAA(FP64 x0, FP64 y0, FP64 r) {
+	transPoint(x0, y0);
+	r *= sqrt(fabs(TransMat(0, 0) * TransMat(1, 1) - TransMat(0, 1) * TransMat(1, 0)));
+	FP64 lim = r / sqrt(2.0);
+	/*------ 上下两段: 沿第二维, |y - y0| <= lim ------*/
+	INT32S st = ceil (y0 - lim) > 0 ? ceil(y0 - lim) : 0,
+		   ed = floor(y0 + lim) < Canvas.cols - 1 ? floor(y0 + lim) : Canvas.cols - 1;
+	for (INT32S y = st; y <= ed; y++) {
+		FP64 h = sqrt(r * r - (y - y0) * (y - y0));
+		for (int s = -1; s <= 1; s += 2) {
+			FP64 x = x0 + s * h;
+			INT32S ix = floor(x);
+			plotAA(ix, y, 1 - (x - ix)); plotAA(ix + 1, y, x - ix);
+		}
+	}
+	/*------ 左右两段: 沿第一维, |x - x0| < lim ------*/
+	st = floor(x0 - lim) + 1 > 0 ? floor(x0 - lim) + 1 : 0;
+	ed = ceil (x0 + lim) - 1 < Canvas.rows - 1 ? ceil(x0 + lim) - 1 : Canvas.rows - 1;
+	for (INT32S x = st; x <= ed; x++) {
+		FP64 h = sqrt(r * r - (x - x0) * (x - x0));
+		for (int s = -1; s <= 1; s += 2) {
+			FP64 y = y0 + s * h;
+			INT32S iy = floor(y);
+			plotAA(x, iy, 1 - (y - iy)); plotAA(x, iy + 1, y - iy);
 		}
-		drawPoint(x, y);
 	}
 }
+void Graphics::drawBezierAA(FP64 xCtrl[], FP64 yCtrl[], INT32S n) {
+	if (n <= 0) return;
+	std::vector<FP64> p(2 * n);
+	FP64 len = 0;
+	for (INT32S i = 0; i < n; i++) {
+		p[2 * i] = xCtrl[i]; p[2 * i + 1] = yCtrl[i];
+		transPoint(p[2 * i], p[2 * i + 1]);
+		if (i > 0) len += sqrt((p[2 * i] - p[2 * i - 2]) * (p[2 * i] - p[2 * i - 2]) + (p[2 * i + 1] - p[2 * i - 1]) * (p[2 * i + 1] - p[2 * i - 1]));
+	}
+	INT32S N = len / 2 < 4 ? 4 : (len / 2 > 4096 ? 4096 : len / 2);	//每段约 2 像素
+	FP64 xPre = p[0], yPre = p[1];
+	bool isFirst = true;
+	bezierForward(p.data(), n, 2, N, [&](const FP64* q) {
+		if (isFirst) { isFirst = false; return; }						//首点
+		lineWu(xPre, yPre, q[0], q[1], Canvas.rows, Canvas.cols, [this](INT32S x, INT32S y, FP64 c, FP64) { plotAA(x, y, c); });
+		xPre = q[0]; yPre = q[1];
+	});
+}
 /*----------------[ 复制别的图 ]---------------- */
 void Graphics::drawCopy(INT32S x0, INT32S y0, Mat<RGB>& gt)
 {
 	for (INT32S x = 0; x < gt.rows; x++)
-		memcpy(Canvas.data + (x0 + x) * Canvas.cols + y0, gt.data + x * gt.cols, sizeof(RGB) * gt.cols);
+		copySpan(x0 + x, y0, gt.data + x * gt.cols, gt.cols);
 }
 /*----------------[ FILL ]----------------*/
 void Graphics::fillRectangle(INT32S sx, INT32S sy, INT32S ex, INT32S ey, ARGB color)
 {
 	if (sy > ey) { INT32S t = ey; ey = sy, sy = t; }
 	if (sx > ex) { INT32S t = ex; ex = sx, sx = t; }
-	for (INT32S y = sy; y <= ey; y++)
-		for (INT32S x = sx; x <= ex; x++)
-			setPoint(x, y, color);
+	INT32S dx, dy;
+	if (!isTranslate(dx, dy)) {
+		for (INT32S y = sy; y <= ey; y++)
+			for (INT32S x = sx; x <= ex; x++)
+				setPoint(x, y, color);
+		return;
+	}
+	sx = sx + dx > 0 ? sx + dx : 0;
+	ex = ex + dx < Canvas.rows ? ex + dx : Canvas.rows - 1;
+	for (INT32S x = sx; x <= ex; x++)
+		fillSpan(x, sy + dy, ey + dy, color);
 }
 /*----------------[ FLOOD FILL ]----------------
-*	广度优先搜索	队列
+*	扫描线种子填充 (Smith / Heckbert), 8 连通
+*	[匹配]: 像素各通道与种子点之差均 <= tolerance.
+*	[过程]:
+*		栈中每项 (x, l, r, dir): 第 x 行 [l, r] 内待查找的种子, 由第 x - dir 行 (父行) 产生.
+*		1.出栈, 在 [l, r] 内找匹配像素, 向左右扩展为最大区间 [L, R], 整段 fillSpan
+*		2.继续沿 dir 方向: 压入 (x + dir, L-1, R+1, dir)
+*		3.区间超出父行范围的部分可能绕回父行: 压入 (x - dir, L-1, l, -dir), (x - dir, r, R+1, -dir)
+*		栈深只与区域边界的复杂程度有关, 与面积无关; 每段按行连续写入.
+*	[访问标记]: 填充后的像素若可能仍然匹配 (半透明、填充色在容差内) 或需输出 mask 时,
+*		以与画布同尺寸的标记图记录已填充像素; 否则已填充像素必不匹配, 无需标记.
+*	[mask]: 非 NULL 时输出填充区域 (0xFF), 尺寸同画布.
+*	种子点 (x0, y0) 经 TransMat 变换, 其余在画布坐标下进行.
 ** ----------------------------------------*/
-void Graphics::fillFlood(INT32S x0, INT32S y0, ARGB color)
+void Graphics::fillFlood(INT32S x0, INT32S y0, ARGB color, INT32S tolerance, Mat<INT8U>* mask)
 {
-	ARGB color0 = readPoint(x0, y0);
-	INT32S x_step[] = { 0,0,1,-1,1,1,-1,-1 },
-	       y_step[] = { 1,-1,0,0,1,-1,1,-1 };
-	std::queue<INT32S> Qx, Qy;
-	Qx.push(x0);
-	Qy.push(y0);
-	setPoint(x0, y0, color);
-	while (!Qx.empty()) {
-		INT32S x = Qx.front(), 
-			   y = Qy.front();
-		for (INT32S i = 0; i < 8; i++) {
-			INT32S xt = x + x_step[i], 
-				   yt = y + y_step[i];
-			if (readPoint(xt, yt) == color0 && !judgeOutRange(xt, yt)) {
-				setPoint(xt, yt, color);
-				Qx.push(xt); 
-				Qy.push(yt);
+	if (TransIsInt) { x0 += TransDx; y0 += TransDy; }
+	else {
+		INT32S xt = TransMat(0, 0) * x0 + TransMat(0, 1) * y0 + TransMat(0, 2),
+		       yt = TransMat(1, 0) * x0 + TransMat(1, 1) * y0 + TransMat(1, 2);
+		x0 = xt; y0 = yt;
+	}
+	if (mask != NULL) mask->zero(Canvas.rows, Canvas.cols);
+	if (judgeOutRange(x0, y0)) return;
+	RGB seed; seed = Canvas(x0, y0);								//须复制: 种子像素本身会被填充, 不能取引用
+	auto isMatch = [&seed, tolerance](const RGB& a) {
+		return abs(a.R - seed.R) <= tolerance
+			&& abs(a.G - seed.G) <= tolerance
+			&& abs(a.B - seed.B) <= tolerance;
+	};
+	Mat<INT8U> visitedTmp;
+	Mat<INT8U>* visited = mask;
+	if (visited == NULL && ((color >> 24) != 0 || isMatch(RGB(color)))) 
+		visited = &visitedTmp.zero(Canvas.rows, Canvas.cols);
+	auto isInside = [&](INT32S x, INT32S y) {
+		return isMatch(Canvas(x, y)) && (visited == NULL || !(*visited)(x, y));
+	};
+	struct Seg { INT32S x, l, r, dir; };
+	std::vector<Seg> stack;
+	stack.push_back({ x0, y0, y0, 1 });
+	while (!stack.empty()) {
+		Seg s = stack.back(); stack.pop_back();
+		if (s.x < 0 || s.x >= Canvas.rows) continue;
+		INT32S l = s.l > 0 ? s.l : 0, 
+			   r = s.r < Canvas.cols - 1 ? s.r : Canvas.cols - 1;
+		for (INT32S y = l; y <= r; y++) {
+			if (!isInside(s.x, y)) continue;
+			//------ 向左右扩展为最大区间 [L, R] ------
+			INT32S L = y, R = y;
+			while (L > 0 && isInside(s.x, L - 1)) L--;
+			while (R < Canvas.cols - 1 && isInside(s.x, R + 1)) R++;
+			fillSpan(s.x, L, R, color);
+			if (visited != NULL) memset(&(*visited)(s.x, L), 0xFF, R - L + 1);
+			//------ 下一行, 及绕回父行的部分 ------
+			stack.push_back({ s.x + s.dir, L - 1, R + 1, s.dir });
+			if (L - 1 <= s.l) stack.push_back({ s.x - s.dir, L - 1, s.l, -s.dir });
+			if (R + 1 >= s.r) stack.push_back({ s.x - s.dir, s.r, R + 1, -s.dir });
+			y = R + 1;
+		}
+	}
+}
+/*----------------[ 描边 (粗线/折线) ]----------------
+*	[目的]: 粗线原为沿线逐步画实心圆, 每像素被重复混合数十次.
+*	[算法]: 将描边分解为若干凸多边形, 统一为正向后交给 fillContours 按非零规则一次填充,
+*		并集内每个像素只写一次 (半透明颜色也不会叠加).
+*		[1] 线段: 沿法向 ±h 的矩形 (h = 线宽 / 2)
+*		[2] 连接 (内部顶点, 闭合时含首尾): 只补外侧缺口
+*			JOIN_ROUND: 圆 (多边形近似, 弦高误差 <= 0.2 像素)
+*			JOIN_MITER: 两外侧角点与斜接点构成的四边形, 斜接比超过 MITER_LIMIT 时退化为 BEVEL
+*			JOIN_BEVEL: 两外侧角点与顶点构成的三角形
+*		[3] 端帽 (不闭合时): CAP_BUTT 无; CAP_ROUND 圆; CAP_SQUARE 向外延伸 h 的矩形
+*	顶点先经 TransMat 变换, 线宽乘以 sqrt|det|.
+** ---------------------------------------- */
+void Graphics::drawPolyline(FP64 xIn[], FP64 yIn[], INT32S n, FP64 width, INT32S join, INT32S cap, bool isClosed)
+{
+	static thread_local std::vector<FP64> px, py, cx, cy;
+	static thread_local std::vector<INT32S> ends;
+	px.clear(); py.clear(); cx.clear(); cy.clear(); ends.clear();
+	FP64 h = width / 2 * sqrt(fabs(TransMat(0, 0) * TransMat(1, 1) - TransMat(0, 1) * TransMat(1, 0)));
+	if (n <= 0 || h <= 0) return;
+	for (INT32S i = 0; i < n; i++) {									//变换, 去除重复点
+		FP64 x = xIn[i], y = yIn[i];
+		transPoint(x, y);
+		if (px.empty() || x != px.back() || y != py.back()) { px.push_back(x); py.push_back(y); }
+	}
+	INT32S m = px.size();
+	if (isClosed && m > 1 && px[0] == px[m - 1] && py[0] == py[m - 1]) m--;
+	if (m <= 2) isClosed = false;
+	//------ 加入一个多边形, 统一为正向 ------
+	auto addPoly = [&](const FP64* qx, const FP64* qy, INT32S k) {
+		FP64 area = 0;
+		for (INT32S i = 0; i < k; i++) area += qx[i] * qy[(i + 1) % k] - qx[(i + 1) % k] * qy[i];
+		if (area == 0) return;
+		for (INT32S i = 0; i < k; i++) {
+			INT32S t = area > 0 ? i : k - 1 - i;
+			cx.push_back(qx[t]); cy.push_back(qy[t]);
+		}
+		ends.push_back(cx.size());
+	};
+	auto addDisk = [&](FP64 x0, FP64 y0) {
+		INT32S N = h > 0.2 ? ceil(PI / acos(1 - 0.2 / h)) : 8;
+		N = N < 8 ? 8 : (N > 512 ? 512 : N);
+		for (INT32S i = 0; i < N; i++) {
+			cx.push_back(x0 + h * cos(2 * PI * i / N));
+			cy.push_back(y0 + h * sin(2 * PI * i / N));
+		}
+		ends.push_back(cx.size());
+	};
+	auto dir = [&](INT32S a, INT32S b, FP64& dx, FP64& dy) {			//a->b 单位方向
+		dx = px[b] - px[a]; dy = py[b] - py[a];
+		FP64 len = sqrt(dx * dx + dy * dy);
+		dx /= len; dy /= len;
+	};
+	if (m == 1) {														//单点: 只有端帽
+		if (cap == CAP_ROUND) addDisk(px[0], py[0]);
+		if (cap == CAP_SQUARE) {
+			FP64 qx[] = { px[0] - h, px[0] + h, px[0] + h, px[0] - h }, qy[] = { py[0] - h, py[0] - h, py[0] + h, py[0] + h };
+			addPoly(qx, qy, 4);
+		}
+	}
+	//------ [1] 线段 ------
+	INT32S segNum = isClosed ? m : m - 1;
+	for (INT32S i = 0; i < segNum; i++) {
+		INT32S a = i, b = (i + 1) % m;
+		FP64 dx, dy; dir(a, b, dx, dy);
+		FP64 nx = -dy * h, ny = dx * h;
+		FP64 qx[] = { px[a] + nx, px[b] + nx, px[b] - nx, px[a] - nx },
+			 qy[] = { py[a] + ny, py[b] + ny, py[b] - ny, py[a] - ny };
+		addPoly(qx, qy, 4);
+	}
+	//------ [2] 连接 ------
+	for (INT32S v = isClosed ? 0 : 1; v < (isClosed ? m : m - 1); v++) {
+		INT32S a = (v - 1 + m) % m, b = (v + 1) % m;
+		FP64 d1x, d1y, d2x, d2y;
+		dir(a, v, d1x, d1y); dir(v, b, d2x, d2y);
+		FP64 cross = d1x * d2y - d1y * d2x, dot = d1x * d2x + d1y * d2y;
+		if (fabs(cross) < 1e-12 && dot > 0) continue;					//共线
+		if (join == JOIN_ROUND) { addDisk(px[v], py[v]); continue; }
+		FP64 s = cross > 0 ? -1 : 1,									//外侧
+			 n1x = -d1y * s, n1y = d1x * s, n2x = -d2y * s, n2y = d2x * s;
+		if (join == JOIN_MITER && 1 + dot > 2 / (MITER_LIMIT * MITER_LIMIT)) {	//斜接比 1/cos(θ/2) = sqrt(2 / (1 + n1·n2))
+			FP64 k = h / (1 + dot);
+			FP64 qx[] = { px[v], px[v] + n1x * h, px[v] + (n1x + n2x) * k, px[v] + n2x * h },
+				 qy[] = { py[v], py[v] + n1y * h, py[v] + (n1y + n2y) * k, py[v] + n2y * h };
+			addPoly(qx, qy, 4);
+			continue;
+		}
+		FP64 qx[] = { px[v], px[v] + n1x * h, px[v] + n2x * h },
+			 qy[] = { py[v], py[v] + n1y * h, py[v] + n2y * h };
+		addPoly(qx, qy, 3);
+	}
+	//------ [3] 端帽 ------
+	if (!isClosed && m > 1) 
+		for (INT32S e = 0; e < 2; e++) {
+			INT32S a = e == 0 ? 1 : m - 2, b = e == 0 ? 0 : m - 1;		//b: 端点, a->b 朝外
+			if (cap == CAP_ROUND) addDisk(px[b], py[b]);
+			if (cap == CAP_SQUARE) {
+				FP64 dx, dy; dir(a, b, dx, dy);
+				FP64 nx = -dy * h, ny = dx * h, ox = dx * h, oy = dy * h;
+				FP64 qx[] = { px[b] + nx, px[b] + nx + ox, px[b] - nx + ox, px[b] - nx },
+					 qy[] = { py[b] + ny, py[b] + ny + oy, py[b] - ny + oy, py[b] - ny };
+				addPoly(qx, qy, 4);
 			}
 		}
-		Qx.pop(); 
-		Qy.pop();
+	fillContours(cx.data(), cy.data(), ends.data(), ends.size(), true, PaintColor);
+}
+/*----------------[ 实心圆/椭圆 ]----------------
+*	逐行求半宽, 整段 fillSpan: 第 x 行半宽 h = floor((ry + 0.5)·sqrt(1 - ((x - x0) / (rx + 0.5))²)).
+*	半径加 0.5 与中点画圆的边界一致. 变换非整数平移时, 以多边形近似后 fillContours.
+** ---------------------------------------- */
+void Graphics::fillCircle(INT32S x0, INT32S y0, INT32S r) { fillEllipse(x0, y0, r, r); }
+void Graphics::fillEllipse(INT32S x0, INT32S y0, INT32S rx, INT32S ry)
+{
+	FP64 a = rx + 0.5, b = ry + 0.5;
+	INT32S dx, dy;
+	if (!isTranslate(dx, dy)) {
+		INT32S N = 4 * (INT32S)(ceil(PI / acos(1 - 0.2 / (a > b ? a : b))) / 4 + 2);
+		std::vector<FP64> xs(N), ys(N);
+		for (INT32S i = 0; i < N; i++) {
+			xs[i] = x0 + a * cos(2 * PI * i / N);
+			ys[i] = y0 + b * sin(2 * PI * i / N);
+			transPoint(xs[i], ys[i]);
+		}
+		fillContours(xs.data(), ys.data(), &N, 1, true, PaintColor);
+		return;
+	}
+	x0 += dx; y0 += dy;
+	INT32S st = x0 - rx > 0 ? x0 - rx : 0,
+		   ed = x0 + rx < Canvas.rows - 1 ? x0 + rx : Canvas.rows - 1;
+	for (INT32S x = st; x <= ed; x++) {
+		FP64 t = (x - x0) / a;
+		INT32S h = floor(b * sqrt(1 - t * t));
+		fillSpan(x, y0 - h, y0 + h, PaintColor);
 	}
 }
 /*----------------[ fillTriangle ]----------------
@@ -333,112 +853,199 @@ void Graphics::fillFlood(INT32S x0, INT32S y0, ARGB color)
 *	水平扫描线从上到下（或从下到上）扫描由多条首尾相连的线段，
 *	使用要求的颜色填充该水平线段上的像素。
 *
-*	利用两张链表列出边，
-*	*边表ET: 待相交边的存储表	*活动边表AET: 目前扫描线相交的边表，
+*	边表ET: 全部非水平边, 存于一个连续数组, 按 ymin 排序一次;
+*	活动边表AET: 与当前扫描线相交的边, 亦为连续数组, 每行按交点 x 插入排序 (相邻行次序几乎不变, 近似 O(k)).
 *	利用ymin确定什么时候考虑该边，利用ymax确定什么时候放弃该边，利用+dx确定交点.
+*	两表为线程内复用的缓冲, 容量只增不减, 多次填充无堆分配.
+*
+*	[填充规则]:
+*		奇偶 (默认): 交点按 x 排序后两两配对.
+*		非零环绕 (isNonZero): 边带方向 ±1, 自左向右累加环绕数, 非零区间填充. 自交/嵌套多边形时二者不同.
+*
+*	[采样]: 扫描线 y 与边相交当且仅当 ymin <= y < ymax (顶点可为浮点); 区间 [xa, xb] 内的整数点被填充.
+*
+*	[多轮廓]: fillContours 可一次填充多个轮廓 (ends[i] 为第 i 个轮廓的终止下标), 各轮廓的边进入同一边表,
+*		非零规则下同向轮廓的并集恰好每个像素填充一次 (描边 drawPolyline 即以此合成线段、连接与端帽).
+*
+*	[坐标]: 扫描线沿画布行 (第一维) 推进, 交点为列坐标, 每段内存连续.
+*		fillPolygon 的顶点先经 TransMat 变换 (浮点), 再在画布坐标下填充; 扫描行裁剪至画布.
 *
 *	[算法流程]:
-*		1.创建链表(链表组): Active-Edge Table活动边表, Edge Table边表组
-*		2.计算扫描区域y最大最小值
-*		3.基于输入边数据, 初始化ET[y]边表组
-*		4.扫描循环开始, 扫描线由Ymin -> Ymax扫描
-*			5.将当前ET[y]中边数据，即刚开始相交的边数据插入AET
-*			6.AET中边两两配对,填充该扫描线
-*			7.删除AET中不再相交的边，即ymax < y+1的边
-*			8.更新AET各边同扫描线的相交点x值
+*		1.建立边表ET, 按ymin排序; 计算扫描区域y最大最小值, 裁剪至画布
+*		2.扫描循环开始, 扫描线由Ymin -> Ymax扫描
+*			3.删除AET中不再相交的边，即ymax <= y的边; 其余边交点 x += dx
+*			4.将ET中ymin <= y的边插入AET, 交点 x 由 ymin 处推算 (首行可能被裁剪)
+*			5.AET按x插入排序
+*			6.按填充规则求各区间, 整段fillSpan
 ** ---------------------------------------- */
-struct fillPolygon_Edge{								//边表(链表)
-	int ymax;											//ymax:边的下端点
-	double x,dx;										//x:当前水平扫描线的交点//dx:斜率m的倒数
-	fillPolygon_Edge* next = NULL;
+struct fillPolygon_Edge{								//边表项
+	int ymin, ymax, dir;								//ymin,ymax:扫描行范围 [ymin, ymax)//dir:方向(y增为+1)
+	double x0, x, dx;									//x0:ymin处x//x:当前水平扫描线的交点//dx:斜率m的倒数
 };
-void Graphics::fillPolygon(INT32S x[], INT32S y[], INT32S n)
+void Graphics::fillPolygon(INT32S xIn[], INT32S yIn[], INT32S n, bool isNonZero)
 {
-	const int ETSzie = 1024;
-	fillPolygon_Edge* AET = new fillPolygon_Edge(), *ET[ETSzie];//Active-Edge Table:活动边表//Edge Table边表
-	//------ 计算y最大最小值 ------
-	int maxY = 0, minY = 0x7FFFFFFF;
+	static thread_local std::vector<FP64> xs, ys;
+	xs.resize(n); ys.resize(n);
 	for (int i = 0; i < n; i++) {
-		maxY = maxY >= y[i] ? maxY : y[i];
-		minY = minY <= y[i] ? minY : y[i];
-	}
-	for (int i = 0; i <= maxY - minY; i++)
-		ET[i] = new fillPolygon_Edge();
-	//------ 建立边表ETy坐标 ------
-	for (int i = 0; i < n; i++){
-		int x1 = x[i], x2 = x[(i + 1) % n],
-			y1 = y[i], y2 = y[(i + 1) % n];
-		if (y1 == y2)continue;							//水平线舍弃
-		int ymin = y1 < y2 ? y1 : y2;
-		fillPolygon_Edge* tE = new fillPolygon_Edge;	//创建新边表节点
-		tE->ymax = y1 > y2 ? y1 : y2; 					//下端点ymin,上端点ymax,下端点x,斜率倒数
-		tE->x    = y1 < y2 ? x1 : x2;
-		tE->dx   = (double)(x2 - x1) / (y2 - y1); 
-		tE->next = ET[ymin - minY]->next;
-		ET[ymin - minY]->next = tE;						//插入ET
+		xs[i] = xIn[i]; ys[i] = yIn[i];
+		transPoint(xs[i], ys[i]);
 	}
-	//------ 扫描线由Ymin -> Ymax扫描 ------
-	for (int y = minY; y <= maxY; y++) {
-		fillPolygon_Edge* p = AET;
-		//------ 将当前ET[y]中边数据，即刚开始相交的边数据插入AET ------
-		while (ET[y - minY]->next) {					//ET[y]链表遍历
-			fillPolygon_Edge* pET = ET[y - minY]->next;
-			while (p->next) {							//AET链表遍历,在AET中搜索合适的插入位置
-				if ((pET->x < p->next->x) || (pET->x == p->next->x && pET->dx < p->next->dx))//按x增序(相等则dx增序)插入AET
-					break;								//找到位置
-				p = p->next;						
-			}
-			ET[y - minY]->next = pET->next;				//ET链表中删除pET
-			pET->next = p->next; p->next = pET;			//pET插入AET的当前位置
+	fillContours(xs.data(), ys.data(), &n, 1, isNonZero, PaintColor);
+}
+void Graphics::fillContours(const FP64 xIn[], const FP64 yIn[], const INT32S ends[], INT32S contourNum, bool isNonZero, ARGB color)
+{
+	const FP64* x = yIn, * y = xIn;									//y: 扫描方向 (画布行), x: 交点 (画布列)
+	static thread_local std::vector<fillPolygon_Edge> ET, AET;		//Edge Table边表//Active-Edge Table:活动边表
+	ET.clear(); AET.clear();
+	//------ 建立边表ET, 计算y最大最小值 ------
+	int maxY = -0x7FFFFFFF, minY = 0x7FFFFFFF;
+	for (int c = 0, st = 0; c < contourNum; st = ends[c++])
+		for (int i = st; i < ends[c]; i++) {
+			int j = i + 1 < ends[c] ? i + 1 : st;
+			FP64 x1 = x[i], x2 = x[j],
+				 y1 = y[i], y2 = y[j];
+			fillPolygon_Edge e;
+			e.ymin = ceil(y1 < y2 ? y1 : y2);
+			e.ymax = ceil(y1 > y2 ? y1 : y2);
+			if (e.ymin >= e.ymax) continue;				//水平线/不跨过整数行的边舍弃
+			e.dir = y1 < y2 ? 1 : -1;
+			e.dx  = (x2 - x1) / (y2 - y1);
+			e.x0  = x1 + (e.ymin - y1) * e.dx;
+			ET.push_back(e);
+			minY = minY <= e.ymin     ? minY : e.ymin;
+			maxY = maxY >= e.ymax - 1 ? maxY : e.ymax - 1;
 		}
-		//------ AET中边两两配对,填充该扫描线 ------
-		p = AET;
-		while (p->next && p->next->next) {				//链表遍历
-			for (int x = p->next->x; x <= p->next->next->x; x++)
-				setPoint(x, y, PaintColor);
-			p = p->next->next;
+	std::sort(ET.begin(), ET.end(), [](const fillPolygon_Edge& a, const fillPolygon_Edge& b) { return a.ymin < b.ymin; });
+	minY = minY >= 0 ? minY : 0;						//只扫描画布内的行
+	maxY = maxY <= Canvas.rows - 1 ? maxY : Canvas.rows - 1;
+	//------ 扫描线由Ymin -> Ymax扫描 ------
+	int etCur = 0, etNum = ET.size();
+	for (int yc = minY; yc <= maxY; yc++) {
+		//------ 删除AET中不再相交的边, 更新交点 ------
+		int k = 0, aetNum = AET.size();
+		for (int i = 0; i < aetNum; i++)
+			if (AET[i].ymax > yc) { AET[k] = AET[i]; AET[k].x += AET[k].dx; k++; }
+		AET.resize(k);
+		//------ 将ET中刚开始相交的边插入AET ------
+		for (; etCur < etNum && ET[etCur].ymin <= yc; etCur++) {
+			fillPolygon_Edge e = ET[etCur];
+			if (e.ymax <= yc) continue;
+			e.x = e.x0 + (yc - e.ymin) * e.dx;
+			AET.push_back(e);
 		}
-		//------ 删除AET中不再相交的边 ------
-		p = AET;
-		while (p->next) {
-			if (p->next->ymax == y + 1) {
-				fillPolygon_Edge* pt = p->next;
-				p->next = pt->next;
-				delete pt;
-			}
-			else p = p->next;
+		aetNum = AET.size();
+		//------ AET按x增序(相等则dx增序)插入排序 ------
+		for (int i = 1; i < aetNum; i++) {
+			fillPolygon_Edge e = AET[i];
+			int j = i - 1;
+			for (; j >= 0 && (e.x < AET[j].x || (e.x == AET[j].x && e.dx < AET[j].dx)); j--) AET[j + 1] = AET[j];
+			AET[j + 1] = e;
 		}
-		//------ 更新AET各边同扫描线的相交点x值 ------
-		p = AET;
-		while (p->next) {
-			p->next->x += p->next->dx;
-			p = p->next;
+		//------ 按填充规则求区间, 填充该扫描线 ------
+		double xa = 0, last = -2;								//last: 本行已填到的列, 相邻区间共享整数边界时不重复填
+		for (int i = 0, wind = 0; i < aetNum; i++) {			//wind: 环绕数 (奇偶规则下为交点计数)
+			bool isIn = isNonZero ? wind != 0 : (wind & 1);
+			wind += isNonZero ? AET[i].dir : 1;
+			bool isInNew = isNonZero ? wind != 0 : (wind & 1);
+			if (!isIn && isInNew) xa = AET[i].x;				//区间开始
+			if (!isIn || isInNew) continue;
+			FP64 sx = ceil(xa), ex = floor(AET[i].x);			//区间结束
+			sx = sx > last + 1 ? sx : last + 1;
+			sx = sx > -1 ? sx : -1;
+			ex = ex < Canvas.cols ? ex : Canvas.cols;
+			if (sx <= ex) { fillSpan(yc, sx, ex, color); last = ex; }
 		}
 	}
 }
-/*----------------[ DRAW CHARACTER ]----------------
-*	字库: font.h
+/*----------------[ 字形图集 ]----------------
+*	字库: font.h, 16 x 8 点阵 (每行两字节). 点阵按 k = FontSize / 16 + 1 放大, 每点 (k+1) x (k+1),
+*	相邻点重叠一像素, 字形尺寸 (16k+1) x (8k+1).
+*	每个 k 只光栅化一次, 得到:
+*		alpha: 95 个字形并排的覆盖掩码 (0 / 0xFF), 供非平移变换时逐点绘制
+*		runs : 各字形各行的连续区间 {s, e}, head[c * (H + 1) + r] 为字符 c 第 r 行区间起点
+** ---------------------------------------- */
+struct GlyphAtlas {
+	int k = 0, H = 0, W = 0;							//放大倍数, 字形高, 字形宽
+	Mat<unsigned char> alpha;
+	std::vector<short> runs;
+	std::vector<int> head;
+};
+static GlyphAtlas& getGlyphAtlas(int k) {
+	static thread_local std::vector<GlyphAtlas> cache;
+	for (auto& a : cache) if (a.k == k) return a;
+	cache.emplace_back();
+	GlyphAtlas& a = cache.back();
+	a.k = k; a.H = 16 * k + 1; a.W = 8 * k + 1;
+	a.alpha.zero(a.H, 95 * a.W);
+	for (int c = 0; c < 95; c++)
+		for (int i = 0; i < 16; i++)
+			for (int j = 0; j < 8; j++) {
+				if (!(asc2_1608[c][i] & (0x80 >> j))) continue;
+				int x = (i & 1) * 8 + j, y = i >> 1;					//点阵坐标
+				for (int u = x * k; u <= (x + 1) * k; u++)
+					memset(&a.alpha(u, c * a.W + y * k), 0xFF, k + 1);
+			}
+	for (int c = 0; c < 95; c++)
+		for (int r = 0; r < a.H; r++) {
+			a.head.push_back(a.runs.size());
+			const unsigned char* row = &a.alpha(r, c * a.W);
+			for (int y = 0; y < a.W; y++) {
+				if (!row[y] || (y > 0 && row[y - 1])) continue;
+				int e = y;
+				while (e + 1 < a.W && row[e + 1]) e++;
+				a.runs.push_back(y); a.runs.push_back(e);
+			}
+			if (r == a.H - 1) a.head.push_back(a.runs.size());
+		}
+	return a;
+}
+/*----------------[ DRAW TEXT ]----------------
+*	[批量]: 整串一次绘制. 逐行收集串内各字形的区间, 排序合并后 fillSpan,
+*		字距小于字宽时重叠部分也只写一次 (半透明文字不叠色).
+*	非整数平移时按 alpha 掩码逐点 setPoint. 字库外字符只占位.
 ** ---------------------------------------- */
-void Graphics::drawChar(INT32S x0, INT32S y0, char charac)
+void Graphics::drawText(INT32S x0, INT32S y0, const char* str, INT32S n)
 {
-	static const INT32S FontLibSize = 16;
-	int k = FontSize / FontLibSize + 1;
-	INT32S x = 0, y = 0;
-	for (INT32S i = 0; i < FontLibSize; i++) {
-		INT8U t = asc2_1608[charac - 32][i];
-		for (INT32S j = 0; j < 8; j++) {
-			if (t & 0x80)
-				fillRectangle(x * k + x0, y * k + y0, (x + 1) * k + x0, (y + 1) * k + y0, PaintColor);
-			t <<= 1;  x++;
-			if (x == FontLibSize) { x = 0;	y++; break; }
+	GlyphAtlas& a = getGlyphAtlas(FontSize / 16 + 1);
+	INT32S dx, dy;
+	if (!isTranslate(dx, dy)) {
+		for (INT32S i = 0; i < n; i++) {
+			INT32S c = (INT8U)str[i] - 32;
+			if (c < 0 || c >= 95) continue;
+			for (INT32S x = 0; x < a.H; x++)
+				for (INT32S y = 0; y < a.W; y++)
+					if (a.alpha(x, c * a.W + y)) setPoint(x0 + x, y0 + FontSize * i + y, PaintColor);
+		}
+		return;
+	}
+	static thread_local std::vector<std::pair<INT32S, INT32S>> spans;
+	x0 += dx; y0 += dy;
+	for (INT32S r = 0; r < a.H; r++) {
+		INT32S x = x0 + r;
+		if (x < 0 || x >= Canvas.rows) continue;
+		spans.clear();
+		for (INT32S i = 0; i < n; i++) {
+			INT32S c = (INT8U)str[i] - 32, base = y0 + FontSize * i;
+			if (c < 0 || c >= 95) continue;
+			INT32S t = c * (a.H + 1) + r;
+			for (INT32S q = a.head[t]; q < a.head[t + 1]; q += 2)
+				spans.push_back({ base + a.runs[q], base + a.runs[q + 1] });
+		}
+		if (spans.empty()) continue;
+		if (FontSize < a.W) std::sort(spans.begin(), spans.end());		//字形重叠时区间可能乱序
+		INT32S sy = spans[0].first, ey = spans[0].second, spanNum = spans.size();
+		for (INT32S q = 1; q < spanNum; q++) {
+			if (spans[q].first <= ey + 1) { ey = ey > spans[q].second ? ey : spans[q].second; continue; }
+			fillSpan(x, sy, ey, PaintColor);
+			sy = spans[q].first; ey = spans[q].second;
 		}
+		fillSpan(x, sy, ey, PaintColor);
 	}
 }
+/*----------------[ DRAW CHARACTER ]----------------*/
+void Graphics::drawChar(INT32S x0, INT32S y0, char charac) { drawText(x0, y0, &charac, 1); }
 /*----------------[ DRAW STRING ]----------------*/
-void Graphics::drawString(INT32S x0, INT32S y0, const char* str)
-{
-	for (int i = 0; str[i] != '\0'; i++) drawChar(x0, y0 + FontSize * i, str[i]);
-}
+void Graphics::drawString(INT32S x0, INT32S y0, const char* str) { drawText(x0, y0, str, strlen(str)); }
 /*----------------[ DRAW NUMBER ]----------------*/
 void Graphics::drawNum(INT32S x0, INT32S y0, FP64 num)
 {
@@ -467,7 +1074,7 @@ void Graphics::drawNum(INT32S x0, INT32S y0, FP64 num)
 			decimal -= (INT32S)decimal;
 		}
 	} numstr[cur] = '\0'; 
-	drawString(x0, y0, numstr);
+	drawText(x0, y0, numstr, cur);
 }
 /******************************************************************************
 
@@ -483,6 +1090,7 @@ void Graphics::translate(INT32S dx, INT32S dy)
 		0, 1, (double)dy,
 		0, 0, 1
 	}, TransMat);
+	updateTrans();
 }
 /*----------------[ ROMOTE ]----------------*/
 void Graphics::rotate(FP64 theta, INT32S x0, INT32S y0) 
@@ -507,4 +1115,18 @@ void Graphics::scale(FP64 sx, FP64 sy, INT32S x0, INT32S y0)
 		 0,  0,  1
 	}, TransMat);
 	translate(x0, y0);
+}
+/*----------------[ 设置/恢复变换 ]----------------
+*	TransMat 为公有成员, 绘制依赖 updateTrans 缓存的变换类型; 经此修改可保证缓存同步.
+** ---------------------------------------- */
+void Graphics::setTrans(Mat<FP64>& M)
+{
+	if (M.rows != 3 || M.cols != 3) Mat<FP64>::error();
+	TransMat = M;
+	updateTrans();
+}
+void Graphics::resetTrans()
+{
+	TransMat.E(3);
+	updateTrans();
 }
\ No newline at end of file
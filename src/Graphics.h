@@ -16,7 +16,8 @@ limitations under the License.
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
-#include <queue>
+#include <vector>
+#include <algorithm>
 #include "font.h"
 #include "../../LiGu_AlgorithmLib/Mat.h"
 #include "RGB.h"
@@ -36,11 +37,19 @@ public:
 	typedef float          FP32;			// Single precision floating point
 	/*--------------------------------  --------------------------------*/
 	Mat<RGB>	Canvas{ 100, 100 };											//ͼ
-	Mat<FP64>	TransMat;													//任
+	Mat<FP64>	TransMat;													//任 ( setTrans/resetTrans ޸; ֱ޸ĺ updateTrans)
+	bool   TransIsInt = true;												//任ǷΪƽ ()
+	INT32S TransDx = 0, TransDy = 0;										//ƽ
 	ARGB PaintColor = 0xFFFFFF;												//ɫ
 	INT32S 
 		PaintSize = 0,														//ʴС
 		FontSize  = 16;														//ַС
+	enum { JOIN_MITER, JOIN_ROUND, JOIN_BEVEL, CAP_BUTT, CAP_ROUND, CAP_SQUARE };	///ñʽ
+	enum { INTERP_NEAREST, INTERP_BILINEAR, INTERP_BICUBIC };				//ֵʽ
+	/*--------------------------------  (Ƭ) --------------------------------*/
+	enum { TILE_BIT = 5, TILE = 1 << TILE_BIT, DIRTY = 1, DRAWN = 2 };	//Ƭ TILE x TILE 
+	Mat<INT8U>	DirtyTile{ 4, 4 };											//Ƭ DIRTY: resetDirty ı, DRAWN: clear 󻭹
+	ARGB		ClearColor = TRANSPARENT;									//ϴɫ
 	/*-------------------------------- ײ㺯 --------------------------------*/
 	Graphics() { ; }
    ~Graphics() { }															//
@@ -48,12 +57,25 @@ public:
 	void init(INT32S width = 100, INT32S height = 100);						//ʼ
 	void clear(ARGB color);	 												//
 	void setPoint		(INT32S x, INT32S y, ARGB color);					//ײ㻭
+	void setPoints		(const INT32S x[], const INT32S y[], const ARGB color[], INT32S n);	// (color == NULL ʱ PaintColor)
+	void fillSpan		(INT32S x, INT32S sy, INT32S ey, ARGB color);		//ײж [sy, ey] (, 任)
+	void copySpan		(INT32S x, INT32S y, const RGB* src, INT32S n);		//ײ㸴ж
+	static void fillPixels(RGB* dst, INT32S n, ARGB color);					///
+	bool isTranslate	(INT32S& dx, INT32S& dy);							//任ǷΪƽ
+	void updateTrans();														//±任
 	ARGB readPoint		(INT32S x, INT32S y); 								// 
 	void readImg	(const char* filename);									//ͼ
 	void writeImg	(const char* filename);									//ͼ
 	bool judgeOutRange	(INT32S x0, INT32S y0);								//жϹ
-	void transSelf();														//ȫͼ任
+	void transSelf		(INT32S interp = INTERP_BILINEAR);					//ȫͼ任 (ӳ, в)
 	void CutSelf		(INT32S sx, INT32S sy, INT32S ex, INT32S ey);		//ͼ
+	/*--------------------------------  --------------------------------*/
+	inline void markTile(INT32S x, INT32S y) { DirtyTile.data[(x >> TILE_BIT) * DirtyTile.cols + (y >> TILE_BIT)] = DIRTY | DRAWN; }	//Ƭ (, Խ)
+	void markDirty		(INT32S sx, INT32S sy, INT32S ex, INT32S ey);		// (); ֱд Canvas 
+	void markDirty		();
+	INT32S getDirtyRects(std::vector<INT32S>& rects);						// {sx, sy, ex, ey}..., ظ
+	void resetDirty		();													//
+	void writeImgDirty	(const char* filename);								//ͼ, ͬߴļѴʱֻд
 	/*-------------------------------- DRAW --------------------------------*/
 	void drawPoint		(INT32S x0, INT32S y0);								//
 	void drawLine		(INT32S x1, INT32S y1, INT32S x2, INT32S y2);		//
@@ -62,18 +84,151 @@ public:
 	void drawRectangle	(INT32S x1, INT32S y1, INT32S x2, INT32S y2);		//
 	void drawPolygon	(INT32S x[],INT32S y[],INT32S n);					//
 	void drawWave		(INT32S x[],INT32S y[],INT32S n);					//
-	void drawBezier		(INT32S x[],INT32S y[],INT32S n);					//
+	void drawBezier		(INT32S x[],INT32S y[],INT32S n);					// (Ƶ, Ӧϸ)
 	void drawGrid		(INT32S sx, INT32S sy, INT32S ex, INT32S ey, INT32S dx, INT32S dy);	//
+	/*--------------------------------  --------------------------------*/
+	void plotAA			(INT32S x, INT32S y, FP64 coverage);				//ʻϻ ()
+	void transPoint		(FP64& x, FP64& y);									//任
+	void drawLineAA		(FP64 x1, FP64 y1, FP64 x2, FP64 y2);				//ֱ
+	void drawCircleAA	(FP64 x0, FP64 y0, FP64 r);							//Բ
+	void drawBezierAA	(FP64 x[], FP64 y[], INT32S n);						//
+	template<class F> static void lineWu(FP64 x1, FP64 y1, FP64 x2, FP64 y2, INT32S X, INT32S Y, F&& plot);	//Wu ֱ (˵, ػص plot)
+	template<class F> static void bezierAdaptive(const FP64 p[], INT32S n, INT32S dim, FP64 tol, F&& emit);	//Bezier ӦϸΪ (ά)
+	template<class F> static void bezierForward (const FP64 p[], INT32S n, INT32S dim, INT32S N,  F&& emit);	//Bezier ̶ N  (ǰ)
 	void drawCopy		(INT32S x0, INT32S y0, Mat<RGB>& gt);								//Ʊͼ
 	void fillRectangle	(INT32S sx, INT32S sy, INT32S ex, INT32S ey, ARGB color);			//䵥ɫ
-	void fillFlood		(INT32S x0, INT32S y0, ARGB color);					//
-	void fillPolygon	(INT32S x[],INT32S y[],INT32S n);					//
+	void fillFlood		(INT32S x0, INT32S y0, ARGB color, INT32S tolerance = 0, Mat<INT8U>* mask = NULL);	// (ݲ, )
+	void fillPolygon	(INT32S x[],INT32S y[],INT32S n, bool isNonZero = false);	// (ż/㻷ƹ)
+	void fillContours	(const FP64 x[], const FP64 y[], const INT32S ends[], INT32S contourNum, bool isNonZero, ARGB color);	// (, ends: յ±)
+	void fillCircle		(INT32S x0, INT32S y0, INT32S r);					//ʵԲ
+	void fillEllipse	(INT32S x0, INT32S y0, INT32S rx, INT32S ry);		//ʵԲ
+	void drawPolyline	(FP64 x[], FP64 y[], INT32S n, FP64 width, INT32S join = JOIN_ROUND, INT32S cap = CAP_ROUND, bool isClosed = false);	// (ÿֻһ)
 	void drawChar		(INT32S x0, INT32S y0, char charac);				//ʾַ
 	void drawString		(INT32S x0, INT32S y0, const char* str);			//ʾַ
+	void drawText		(INT32S x0, INT32S y0, const char* str, INT32S n);	//ʾ n ַ (ͼ, )
 	void drawNum		(INT32S x0, INT32S y0, FP64 num);					//ʾ
 	/*-------------------------------- ά任 --------------------------------*/
 	void translate		(INT32S dx, INT32S dy);								//ƽ
 	void rotate			(FP64 theta,		INT32S x0, INT32S y0);			//ת
 	void scale			(FP64 sx, FP64 sy,	INT32S x0, INT32S y0);			//
+	void setTrans		(Mat<FP64>& M);										//ñ任 (3x3)
+	void resetTrans		();													//ָȱ任
 };
+/******************************************************************************
+
+*                    ģ庯
+
+******************************************************************************/
+/*---------------- Wu ֱ ----------------
+*	ÿ, ʰ㵽ĵľ; ˵㰴ϸǵĳȼȨ.
+*	plot(x, y, coverage, t): t  [0, 1] Ϊ߶ϵĲ (ֵȵ). ᰴ [0, X) / [0, Y) ü.
+**-----------------------------------------*/
+template<class F>
+void Graphics::lineWu(FP64 x1, FP64 y1, FP64 x2, FP64 y2, INT32S X, INT32S Y, F&& plot) {
+	bool isSteep = fabs(y2 - y1) > fabs(x2 - x1);
+	if (isSteep) { std::swap(x1, y1); std::swap(x2, y2); std::swap(X, Y); }
+	bool isRev = x1 > x2;
+	if (isRev) { std::swap(x1, x2); std::swap(y1, y2); }
+	FP64 dx = x2 - x1, grad = dx == 0 ? 0 : (y2 - y1) / dx;
+	auto put = [&](INT32S a, FP64 b, FP64 c) {					// a, ύ b 
+		INT32S ib = floor(b);
+		FP64 f = b - ib, t = dx == 0 ? 0 : (a - x1) / dx;
+		t = t < 0 ? 0 : (t > 1 ? 1 : t);
+		if (isRev) t = 1 - t;
+		if (isSteep) { plot(ib, a, c * (1 - f), t); plot(ib + 1, a, c * f, t); }
+		else		 { plot(a, ib, c * (1 - f), t); plot(a, ib + 1, c * f, t); }
+	};
+	INT32S xa = floor(x1 + 0.5), xb = floor(x2 + 0.5);
+	if (xa == xb) { put(xa, (y1 + y2) / 2, dx); return; }		//һ
+	put(xa, y1 + grad * (xa - x1), xa + 0.5 - x1);				//˵
+	put(xb, y2 + grad * (xb - x2), x2 + 0.5 - xb);
+	INT32S st = xa + 1 > 0 ? xa + 1 : 0,
+		   ed = xb - 1 < X - 1 ? xb - 1 : X - 1;
+	FP64 y = y1 + grad * (st - x1);
+	for (INT32S x = st; x <= ed; x++, y += grad) put(x, y, 1);
+}
+/*---------------- Bezier ɢ ----------------
+*	Ƶ p: n  dim ά (); emit(q) յ߶ q[dim], ĩ.
+*	bezierAdaptive: de Casteljau Ӧ. ڲƵ㵽ĩ߶εľ <= tol ʱöΪֱ (͹),
+*		 t = 1/2 Ϊμ; ̶߳, 뻭С޹.  <= 16.
+*	bezierForward : ̶ N . μǰ, ÿֻ dim(n-1) μӷ;
+*		ߴʱǰ C(N, n-1) Ŵ, Ϊ de Casteljau.
+**-----------------------------------------*/
+template<class F>
+void Graphics::bezierAdaptive(const FP64 p[], INT32S n, INT32S dim, FP64 tol, F&& emit) {
+	if (n <= 0) return;
+	emit(p);
+	if (n == 1) return;
+	INT32S sz = n * dim;
+	std::vector<FP64> stack(p, p + sz), work(sz), left(sz);
+	std::vector<INT32S> depth(1, 0);
+	while (!depth.empty()) {
+		INT32S d = depth.back(); depth.pop_back();
+		const FP64* q = &stack[stack.size() - sz];
+		/*------ ƽֱ: ڲƵ㵽 (߶ζֱ) ľƽ; ߵԽ˵ĿƵ㲻ƽֱ ------*/
+		FP64 chord2 = 0, err2 = 0;
+		for (INT32S k = 0; k < dim; k++) chord2 += (q[sz - dim + k] - q[k]) * (q[sz - dim + k] - q[k]);
+		for (INT32S i = 1; i < n - 1 && err2 <= tol * tol; i++) {
+			FP64 v2 = 0, vd = 0;
+			for (INT32S k = 0; k < dim; k++) {
+				FP64 v = q[i * dim + k] - q[k];
+				v2 += v * v; vd += v * (q[sz - dim + k] - q[k]);
+			}
+			FP64 e = v2;											//ͶӰ׵: ׵ľ
+			if (vd > chord2) {										//ͶӰĩ: ĩľ
+				e = 0;
+				for (INT32S k = 0; k < dim; k++) e += (q[i * dim + k] - q[sz - dim + k]) * (q[i * dim + k] - q[sz - dim + k]);
+			}
+			else if (vd > 0) e = v2 - vd * vd / chord2;				//ͶӰ: ҵľ
+			err2 = err2 > e ? err2 : e;
+		}
+		if (err2 <= tol * tol || d >= 16) {
+			emit(q + sz - dim);
+			stack.resize(stack.size() - sz);
+			continue;
+		}
+		/*------ t = 1/2 : ȡ׵, Ҷȡĩ ------*/
+		work.assign(q, q + sz);											//ԭؼ,  r ĩ work[n-1-r], ΪҶ
+		for (INT32S r = 0; r < n; r++) {
+			for (INT32S k = 0; k < dim; k++) left[r * dim + k] = work[k];
+			for (INT32S i = 0; i < n - 1 - r; i++)
+				for (INT32S k = 0; k < dim; k++)
+					work[i * dim + k] = (work[i * dim + k] + work[(i + 1) * dim + k]) / 2;
+		}
+		std::copy(work.begin(), work.end(), stack.end() - sz);			//Ҷѹ, ȳջ
+		stack.insert(stack.end(), left.begin(), left.end());
+		depth.push_back(d + 1); depth.push_back(d + 1);
+	}
+}
+template<class F>
+void Graphics::bezierForward(const FP64 p[], INT32S n, INT32S dim, INT32S N, F&& emit) {
+	if (n <= 0) return;
+	emit(p);
+	if (n == 1 || N <= 0) return;
+	std::vector<FP64> b(n * dim), q(dim);
+	auto eval = [&](FP64 u, FP64* out) {							//de Casteljau
+		b.assign(p, p + n * dim);
+		for (INT32S r = 1; r < n; r++)
+			for (INT32S i = 0; i < n - r; i++)
+				for (INT32S k = 0; k < dim; k++)
+					b[i * dim + k] = (1 - u) * b[i * dim + k] + u * b[(i + 1) * dim + k];
+		for (INT32S k = 0; k < dim; k++) out[k] = b[k];
+	};
+	if (n > 4) {
+		for (INT32S s = 1; s <= N; s++) { eval((FP64)s / N, q.data()); emit(q.data()); }
+		return;
+	}
+	/*------ ǰ: D[j] Ϊ j ײ, ǰ n Ĳֱõ ------*/
+	std::vector<FP64> D(n * dim);
+	for (INT32S j = 0; j < n; j++) eval((FP64)j / N, &D[j * dim]);
+	for (INT32S j = 1; j < n; j++)
+		for (INT32S i = n - 1; i >= j; i--)
+			for (INT32S k = 0; k < dim; k++) D[i * dim + k] -= D[(i - 1) * dim + k];
+	for (INT32S s = 1; s < N; s++) {
+		for (INT32S j = 0; j < n - 1; j++)
+			for (INT32S k = 0; k < dim; k++) D[j * dim + k] += D[(j + 1) * dim + k];
+		emit(D.data());
+	}
+	emit(p + (n - 1) * dim);											//ĩ㾫ȷһƵ
+}
 #endif
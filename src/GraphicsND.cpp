@@ -11,7 +11,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include "GraphicsND.h"
-Mat<> GraphicsND::TransformMat;											//变换矩阵
+Mat<GraphicsND::real> GraphicsND::TransformMat;											//变换矩阵
 unsigned int GraphicsND::FaceColor = 0xFFFFFF;
 /*#############################################################################
 
@@ -38,11 +38,23 @@ void GraphicsND::clear(ARGB color) {
 }
 /*--------------------------------[ 点 To 像素 ]--------------------------------*/
 void GraphicsND::value2pix(double x0, double y0, double z0, int& x, int& y, int& z) {
-	Mat<> point(TransformMat.rows); 
-	point.mul(TransformMat, point = { 1,x0,y0,z0 });
-	x = point[1]; 
-	y = point[2]; 
-	z = point[3];
+	if (TransformMat.rows == 4) {								//3D: 定长点, 免堆分配
+		Mat<real, 4> point{ 1, (real)x0, (real)y0, (real)z0 };
+		point.mul(TransformMat, point);
+		x = point[1];
+		y = point[2];
+		z = point[3];
+	}
+	else {														//2D/4D+: 齐次坐标维数随变换矩阵, 2D 无 z
+		Mat<real> point;
+		point.zero(TransformMat.rows);
+		point[0] = 1; point[1] = x0; point[2] = y0;
+		if (point.rows > 3) point[3] = z0;
+		point.mul(TransformMat, point);
+		x = point[1];
+		y = point[2];
+		z = point.rows > 3 ? point[3] : 0;
+	}
 	if (perspective != 0) {
 		if (z > perspective / 3) { x = y = 0x7FFFFFFF; return; }
 		x *= 1 / (z / -perspective + 1);
@@ -52,9 +64,36 @@ void GraphicsND::value2pix(double x0, double y0, double z0, int& x, int& y, int&
 	x = g.Canvas.rows / 2 - x;
 	y = g.Canvas.cols / 2 + y;
 }
-void GraphicsND::value2pix(Mat<>& p0, Mat<int>& pAns) {
+void GraphicsND::value2pix(double x0, double y0, double z0, double& x, double& y, double& z) {	//浮点像素坐标 (供反走样)
+	if (TransformMat.rows == 4) {
+		Mat<real, 4> point{ 1, (real)x0, (real)y0, (real)z0 };
+		point.mul(TransformMat, point);
+		x = point[1];
+		y = point[2];
+		z = point[3];
+	}
+	else {														//2D/4D+: 齐次坐标维数随变换矩阵, 2D 无 z
+		Mat<real> point;
+		point.zero(TransformMat.rows);
+		point[0] = 1; point[1] = x0; point[2] = y0;
+		if (point.rows > 3) point[3] = z0;
+		point.mul(TransformMat, point);
+		x = point[1];
+		y = point[2];
+		z = point.rows > 3 ? point[3] : 0;
+	}
+	if (perspective != 0) {
+		if (z > perspective / 3) { x = y = 0x7FFFFFFF; return; }
+		x *= 1 / (z / -perspective + 1);
+		y *= 1 / (z / -perspective + 1);
+	}
+	std::swap(x, y);
+	x = g.Canvas.rows / 2 - x;
+	y = g.Canvas.cols / 2 + y;
+}
+void GraphicsND::value2pix(Mat<real>& p0, Mat<int>& pAns) {
 	pAns.zero(p0.rows);
-	static Mat<> point; point.zero(TransformMat.rows);
+	static Mat<real> point; point.zero(TransformMat.rows);
 	point[0] = 1; for (int i = 0; i < p0.rows; i++) point[i + 1] = p0[i];
 	point.mul(TransformMat, point); 
 	for (int i = 0; i < pAns.rows; i++) pAns[i] = point[i + 1];
@@ -85,8 +124,8 @@ bool GraphicsND::setPix(Mat<int>& p0, int size, unsigned int color) {
 	return true;
 }
 /*--------------------------------[ 设置坐标范围 ]--------------------------------*/
-void GraphicsND::setAxisLim(Mat<>& pMin, Mat<>& pMax) {
-	Mat<> redio, tmp;
+void GraphicsND::setAxisLim(Mat<real>& pMin, Mat<real>& pMax) {
+	Mat<real> redio, tmp;
 	redio.sub(pMax, pMin);
 	for (int i = 0; i < redio.rows; i++) {
 		if (i == 1) redio[i] = g.Canvas.rows / redio[i];
@@ -111,8 +150,8 @@ void GraphicsND::writeModel(const char* fileName) {
 	GraphicsFileCode::stlWrite(fileName, head, fv, p[0], p[1], p[2], attr);
 }
 /*--------------------------------[ 着色器函数例子 ]--------------------------------*/
-unsigned int GraphicsND::FaceColorF_1(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
-	static Mat<> t1, t2, faceVec, light(3); light = 1 / sqrt(3);
+unsigned int GraphicsND::FaceColorF_1(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3) {
+	static Mat<real> t1, t2, faceVec, light(3); light = 1 / sqrt(3);
 	double t = (faceVec.cross_(
 		t1.sub(p2, p1),
 		t2.sub(p3, p1)
@@ -121,7 +160,7 @@ unsigned int GraphicsND::FaceColorF_1(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
 		 + (int)(t * (unsigned char)(FaceColor >> 8)) * 0x100
 		 + (int)(t * (unsigned char)(FaceColor));
 }
-unsigned int GraphicsND::FaceColorF_2(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
+unsigned int GraphicsND::FaceColorF_2(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3) {
 	return FaceColor;
 }
 /*#############################################################################
@@ -140,7 +179,7 @@ void GraphicsND::drawPoint(double x0, double y0, double z0) {
 	value2pix(x0, y0, z0, x, y, z);
 	setPix(x, y, z);
 }
-void GraphicsND::drawPoint(Mat<>& p0) {
+void GraphicsND::drawPoint(Mat<real>& p0) {
 	Mat<int> p;
 	value2pix(p0, p);
 	setPix(p);
@@ -167,6 +206,15 @@ void GraphicsND::drawPoint(Mat<>& p0) {
 			[5] 累计 x_err, 进位 x
 ******************************************************************************/
 void GraphicsND::drawLine(double sx0, double ex0, double sy0, double ey0, double sz0, double ez0) {
+	if (ANTIALIAS && TransformMat.rows == 4) {
+		drawLineAA(sx0, ex0, sy0, ey0, sz0, ez0);
+		if (isLineTriangleSet) {
+			Mat<real> tmp(3);
+			LineSet.push_back(tmp.set(sx0, sy0, sz0));
+			LineSet.push_back(tmp.set(ex0, ey0, ez0));
+		}
+		return;
+	}
 	//[1]
 	int sx, sy, sz, ex, ey, ez;
 	value2pix(sx0, sy0, sz0, sx, sy, sz); 
@@ -195,12 +243,20 @@ void GraphicsND::drawLine(double sx0, double ex0, double sy0, double ey0, double
 	}
 	//LineSet
 	if (isLineTriangleSet) {
-		Mat<> tmp(3);
+		Mat<real> tmp(3);
 		LineSet.push_back(tmp.set(sx0, sy0, sz0));
 		LineSet.push_back(tmp.set(ex0, ey0, ez0));
 	}
 }
-void GraphicsND::drawLine(Mat<>& sp0, Mat<>& ep0) {
+void GraphicsND::drawLine(Mat<real>& sp0, Mat<real>& ep0) {
+	if (ANTIALIAS && TransformMat.rows == 4 && sp0.rows <= 3) {
+		drawLineAA(sp0[0], ep0[0], sp0[1], ep0[1], sp0.rows > 2 ? sp0[2] : 0, ep0.rows > 2 ? ep0[2] : 0);
+		if (isLineTriangleSet) {
+			LineSet.push_back(sp0);
+			LineSet.push_back(ep0);
+		}
+		return;
+	}
 	Mat<int> sp, ep;
 	value2pix(sp0, sp); 
 	value2pix(ep0, ep);
@@ -228,37 +284,53 @@ void GraphicsND::drawLine(Mat<>& sp0, Mat<>& ep0) {
 		LineSet.push_back(ep0);
 	}
 }
+/*--------------------------------[ 反走样直线 ]--------------------------------
+*	Wu 算法 (Graphics::lineWu), 浮点像素坐标; 深度沿线段线性插值, 逐像素深度测试后按覆盖率混合.
+**-----------------------------------------------------------------------------*/
+void GraphicsND::drawLineAA(double sx0, double ex0, double sy0, double ey0, double sz0, double ez0) {
+	double sx, sy, sz, ex, ey, ez;
+	value2pix(sx0, sy0, sz0, sx, sy, sz);
+	value2pix(ex0, ey0, ez0, ex, ey, ez);
+	if (sx == 0x7FFFFFFF || ex == 0x7FFFFFFF) return;
+	bool isDepth = Z_Buffer.rows > 0;							//2D 无深度缓存
+	Graphics::lineWu(sx, sy, ex, ey, g.Canvas.rows, g.Canvas.cols, [&](int x, int y, double coverage, double t) {
+		int z = sz + (ez - sz) * t;
+		if (g.judgeOutRange(x, y) || (isDepth && z < Z_Buffer[0](x, y))) return;
+		g.plotAA(x, y, coverage);
+		if (isDepth) Z_Buffer[0](x, y) = z;
+	});
+}
 /******************************************************************************
 *                    画折线
 ******************************************************************************/
-void GraphicsND::drawPolyline(Mat<> *p, int n, bool close) {
+void GraphicsND::drawPolyline(Mat<real> *p, int n, bool close) {
 	for (int i = 0; i < n - 1; i++) drawLine(p[i], p[i + 1]);
 	if (close) drawLine(p[0], p[n - 1]);
 }
 /******************************************************************************
 *                    画Bezier曲线
+*	[算法]: de Casteljau 自适应细分 (Graphics::bezierAdaptive), 任意维数、任意控制点数, 细分后逐段 drawLine.
+*	[容差]: 0.5 像素, 按 TransformMat 线性部分的 Frobenius 范数换算到原坐标; 透视时仅为近似.
 ******************************************************************************/
-void GraphicsND::drawBezierLine(Mat<> p[], int n) {
-	/*
-	int N = 1000;					//#待优化
-	FP64 C[50];
+void GraphicsND::drawBezierLine(Mat<real> p[], int n) {
+	if (n <= 0) return;
+	int dim = p[0].rows;
+	std::vector<double> ctrl(n * dim);
 	for (int i = 0; i < n; i++)
-		setPoint(xCtrl[i], yCtrl[i], 0xFFFFFF);
-	for (INT32S i = 0; i < n; i++) {
-		C[i] = 1;
-		for (INT32S j = n - 1; j >= i + 1; j--) C[i] *= j;
-		for (INT32S j = n - 1 - i; j >= 2; j--) C[i] /= j;
-	}
-	for (INT32S k = 0; k < N; k++) {
-		FP64 u = (FP64)k / N;
-		INT32S x = 0, y = 0;
-		for (INT32S i = 0; i < n; i++) {
-			FP64 bezBlendFcn = C[i] * pow(u, i) * pow(1 - u, n - 1 - i);
-			x += xCtrl[i] * bezBlendFcn;
-			y += yCtrl[i] * bezBlendFcn;
-		}
-		drawPoint(x, y);
-	}*/
+		for (int k = 0; k < dim; k++) ctrl[i * dim + k] = p[i][k];
+	double norm = 0;
+	for (int i = 1; i < TransformMat.rows; i++)
+		for (int j = 1; j <= dim && j < TransformMat.cols; j++) norm += TransformMat(i, j) * TransformMat(i, j);
+	norm = sqrt(norm);
+	Mat<real> pre(dim), cur(dim);
+	bool isFirst = true;
+	Graphics::bezierAdaptive(ctrl.data(), n, dim, norm > 0 ? 0.5 / norm : 0.5, [&](const double* q) {
+		for (int k = 0; k < dim; k++) cur[k] = q[k];
+		if (!isFirst) drawLine(pre, cur);
+		else if (n == 1) drawPoint(cur);
+		isFirst = false;
+		pre = cur;
+	});
 }
 /******************************************************************************
 *                    画三角形
@@ -275,7 +347,7 @@ void GraphicsND::drawBezierLine(Mat<> p[], int n) {
 			[4] 若到达三角形第三顶点，则短边转换至该点方程
 			[5] 画线
 ******************************************************************************/
-void GraphicsND::drawTriangle(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
+void GraphicsND::drawTriangle(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3) {
 	if (FACE) {
 		//[1]
 		static Mat<int> pt[3];
@@ -363,8 +435,8 @@ void GraphicsND::drawTriangle(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
 	}
 }
 /*--------------------------------[ 画三角形集 ]--------------------------------*/
-void GraphicsND::drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
-	Mat<> pt1(p1.rows), 
+void GraphicsND::drawTriangleSet(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3) {
+	Mat<real> pt1(p1.rows), 
 		  pt2(p2.rows), 
 		  pt3(p3.rows), 
 		  fvt(p1.rows),
@@ -376,8 +448,8 @@ void GraphicsND::drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3) {
 			p3.getCol(i, pt3)
 		);
 }
-void GraphicsND::drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& FaceVec) {
-	Mat<> pt1(p1	 .rows), 
+void GraphicsND::drawTriangleSet(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>& FaceVec) {
+	Mat<real> pt1(p1	 .rows), 
 		  pt2(p2	 .rows), 
 		  pt3(p3	 .rows), 
 		  fvt(FaceVec.rows),
@@ -394,9 +466,9 @@ void GraphicsND::drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& FaceVec
 	}
 }
 /*--------------------------------[ 画矩形 ]--------------------------------*/
-void GraphicsND::drawRectangle(Mat<>& sp, Mat<>& ep, Mat<>* direct) {
+void GraphicsND::drawRectangle(Mat<real>& sp, Mat<real>& ep, Mat<real>* direct) {
 	if (direct == NULL) {
-		Mat<> pt = sp;
+		Mat<real> pt = sp;
 		if(FACE)
 			drawTriangle(sp, ep, pt = { sp[0], ep[1] }),
 			drawTriangle(sp, ep, pt = { ep[0], sp[1] });
@@ -410,7 +482,7 @@ void GraphicsND::drawRectangle(Mat<>& sp, Mat<>& ep, Mat<>* direct) {
 	}
 }
 /*--------------------------------[ 画四边形 ]--------------------------------*/
-void GraphicsND::drawQuadrangle(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4) {
+void GraphicsND::drawQuadrangle(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>& p4) {
 	if (FACE) {
 		drawTriangle(p1, p2, p3); drawTriangle(p1, p3, p4);
 	}
@@ -433,7 +505,7 @@ void GraphicsND::drawQuadrangle(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4) {
 	五边形:	[1] 1 2 3, 3 4 5 [2] 1 3 5
 		  
 -----------------------------------------------------------------------------*/
-void GraphicsND::drawPolygon(Mat<> p[], int n) { 
+void GraphicsND::drawPolygon(Mat<real> p[], int n) { 
 	if (FACE) 
 		for (int k = 1; k <= (n + 2) / 3; k++) 
 			for (int i = 0; i <= n - 2 * k; i += 2 * k) 
@@ -455,10 +527,10 @@ void GraphicsND::drawPolygon(Mat<> p[], int n) {
 		sin(Φ + α) = 0    α = arcsin(C1 / sqrt(C1² + C²))
 		Φ = - arcsin(C1 / sqrt(C1² + C²))
 **-----------------------------------------------------------------------*/
-void GraphicsND::drawCircle(Mat<>& center, double r, double delta, Mat<>* direct) {
+void GraphicsND::drawCircle(Mat<real>& center, double r, double delta, Mat<real>* direct) {
 	if (direct == NULL) {
 		double dAngle = 2 * PI / delta;
-		Mat<> ps(2), pe(2);
+		Mat<real> ps(2), pe(2);
 		for (int i = 0; i < delta; i++) {
 			double theta = i * dAngle;
 			ps = { r * cos(theta),          r * sin(theta) };
@@ -468,10 +540,10 @@ void GraphicsND::drawCircle(Mat<>& center, double r, double delta, Mat<>* direct
 		}
 	}
 }
-void GraphicsND::drawSector(Mat<>& center, double r, double angleSt, double angleEd, double delta, Mat<>* direct) {
+void GraphicsND::drawSector(Mat<real>& center, double r, double angleSt, double angleEd, double delta, Mat<real>* direct) {
 	if (direct == NULL) {
 		double dAngle = (angleEd - angleSt) / delta;
-		Mat<> ps(2), pe(2);
+		Mat<real> ps(2), pe(2);
 		for (int i = 0; i < delta; i++) {
 			double theta = angleSt + i * dAngle;
 			ps = { r * cos(theta),          r * sin(theta) };
@@ -500,11 +572,11 @@ void GraphicsND::drawSector(Mat<>& center, double r, double angleSt, double angl
 		sin(Φ + α) = 0    α = arcsin(C1 / sqrt(C1² + C²))
 		Φ = - arcsin(C1 / sqrt(C1² + C²))
 **-----------------------------------------------------------------------*/
-void GraphicsND::drawEllipse(Mat<>& center, double rx, double ry, Mat<>* direct) {
+void GraphicsND::drawEllipse(Mat<real>& center, double rx, double ry, Mat<real>* direct) {
 }
 /*--------------------------------[ 画曲面 ]--------------------------------*/
-void GraphicsND::drawSurface(Mat<>& z, double xs, double xe, double ys, double ye, Mat<>* direct) {
-	Mat<> p(3), pl(3), pu(3), plu(3); Mat<> FaceVec, tmp, light(3); light = 1 / sqrt(3);
+void GraphicsND::drawSurface(Mat<real>& z, double xs, double xe, double ys, double ye, Mat<real>* direct) {
+	Mat<real> p(3), pl(3), pu(3), plu(3); Mat<real> FaceVec, tmp, light(3); light = 1 / sqrt(3);
 	double dx = (xe - xs) / z.rows, 
 		   dy = (ye - ys) / z.cols;
 	for (int y = 0; y < z.cols; y++) {
@@ -530,7 +602,7 @@ void GraphicsND::drawSurface(Mat<>& z, double xs, double xe, double ys, double y
 	}
 }
 /*--------------------------------[ 画四面体 ]--------------------------------*/
-void GraphicsND::drawTetrahedron(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4) {
+void GraphicsND::drawTetrahedron(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>& p4) {
 	if (FACE) {
 		drawTriangle(p1, p2, p3); 
 		drawTriangle(p2, p3, p4); 
@@ -552,8 +624,8 @@ void GraphicsND::drawTetrahedron(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4) {
 		(x0,y1,z0)&(x0,y0,z1)  (x0,y1,z0)&(x1,y0,z0)
 		(x0,y0,z1)&(x1,y0,z0)  (x0,y0,z1)&(x0,y1,z1)
 **------------------------------------------------------------------------*/
-void GraphicsND::drawCuboid(Mat<>& pMin, Mat<>& pMax) {
-	Mat<> pMinTmp[3], pMaxTmp[3];
+void GraphicsND::drawCuboid(Mat<real>& pMin, Mat<real>& pMax) {
+	Mat<real> pMinTmp[3], pMaxTmp[3];
 	for (int i = 0; i < 3; i++) {
 		pMinTmp[i] = pMin; pMinTmp[i][i] = pMax[i];
 		pMaxTmp[i] = pMax; pMaxTmp[i][i] = pMin[i];
@@ -578,9 +650,9 @@ void GraphicsND::drawCuboid(Mat<>& pMin, Mat<>& pMax) {
 		[1] 计算旋转矩阵
 		[2] 根据旋转矩阵, 计算绘制点坐标, 完成绘制
 **------------------------------------------------------------------------*/
-void GraphicsND::drawFrustum(Mat<>& st, Mat<>& ed, double Rst, double Red, double delta) {
+void GraphicsND::drawFrustum(Mat<real>& st, Mat<real>& ed, double Rst, double Red, double delta) {
 	// 计算 Rotate Matrix
-	Mat<> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
+	Mat<real> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
 	direction.sub(ed, st);
 	if (direction[0] != 0 || direction[1] != 0) {
 		rotate(
@@ -591,7 +663,7 @@ void GraphicsND::drawFrustum(Mat<>& st, Mat<>& ed, double Rst, double Red, doubl
 		rotateMat.block(1, 3, 1, 3, rotateMat);
 	} else rotateMat.E(3);
 	// 画圆台
-	Mat<> stPoint, edPoint, preStPoint, preEdPoint, deltaVector(3);
+	Mat<real> stPoint, edPoint, preStPoint, preEdPoint, deltaVector(3);
 	for (int i = 0; i <= delta; i++) {
 		deltaVector.set(
 			cos(i * 2.0 * PI / delta),
@@ -619,7 +691,7 @@ void GraphicsND::drawFrustum(Mat<>& st, Mat<>& ed, double Rst, double Red, doubl
 	}
 }
 /*--------------------------------[ 画圆柱 ]--------------------------------*/
-void GraphicsND::drawCylinder(Mat<>& st, Mat<>& ed, double r, double delta) {
+void GraphicsND::drawCylinder(Mat<real>& st, Mat<real>& ed, double r, double delta) {
 	drawFrustum(st, ed, r, r, delta);
 }
 /*--------------------------------[ 画球 ]--------------------------------
@@ -632,10 +704,10 @@ void GraphicsND::drawCylinder(Mat<>& st, Mat<>& ed, double r, double delta) {
 		[1] 画纬度线
 		[2] 画经度线
 **-----------------------------------------------------------------------*/
-void GraphicsND::drawSphere(Mat<>& center, double r, 
+void GraphicsND::drawSphere(Mat<real>& center, double r, 
 	double thetaSt, double thetaEd, double phiSt, double phiEd, double dAngle
 ) {
-	Mat<> point(3), pointU(3), pointL(3), pointUL(3);
+	Mat<real> point(3), pointU(3), pointL(3), pointUL(3);
 	int ThetaNum = (thetaEd - thetaSt) / dAngle,
 		  PhiNum = (  phiEd -   phiSt) / dAngle;
 	for (int i = 1; i <= ThetaNum; i++) {
@@ -666,16 +738,16 @@ void GraphicsND::drawSphere(Mat<>& center, double r,
 		}
 	}
 }
-void GraphicsND::drawSphere(Mat<>& center, double r, double dAngle) {
+void GraphicsND::drawSphere(Mat<real>& center, double r, double dAngle) {
 	drawSphere(center, r, 0, 2 * PI, -PI / 2, PI / 2, dAngle);
 }
 /*--------------------------------[ getSphereFibonacciPoint 球面均匀点分布 ]--------------------------------
 *	[Referance]:
 		[1] Thanks and copyright for https://github.com/SebLague/Boids
 **---------------------------------------------------------------------------------------------------------*/
-void GraphicsND::drawSphere2(Mat<>& center, double r, int n) {
+void GraphicsND::drawSphere2(Mat<real>& center, double r, int n) {
 	// 均匀球面点
-	Mat<> point(3);
+	Mat<real> point(3);
 	double goldenRatio = (1 + sqrt(5)) / 2;				// 黄金分割点
 	double angleIncrement = PI * 2 * goldenRatio;
 	for (int i = 0; i < 300; i++) {
@@ -696,9 +768,9 @@ void GraphicsND::drawSphere2(Mat<>& center, double r, int n) {
 		[1] 画纬度线
 		[2] 画经度线
 **-----------------------------------------------------------------------*/
-void GraphicsND::drawEllipsoid(Mat<>& center, Mat<>& r) {
+void GraphicsND::drawEllipsoid(Mat<real>& center, Mat<real>& r) {
 	const int delta = 5;
-	Mat<> point(3);
+	Mat<real> point(3);
 	for (int i = 0; i < 360 / delta; i++) {
 		double theta = (i * delta) * 2.0 * PI / 360;
 		for (int j = -90 / delta; j <= 90 / delta; j++) {
@@ -713,10 +785,10 @@ void GraphicsND::drawEllipsoid(Mat<>& center, Mat<>& r) {
 /******************************************************************************
 *                    画平移体
 ******************************************************************************/
-void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, double Rst, double Red, int delta) {
+void GraphicsND::drawPipe(Mat<real>& st, Mat<real>& ed, double Rst, double Red, int delta) {
 	if (Red == -1) Red = Rst;
 	// 计算 Rotate Matrix
-	Mat<> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
+	Mat<real> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
 	direction.sub(ed, st);
 	if (direction[0] != 0 || direction[1] != 0) {
 		rotate(
@@ -727,7 +799,7 @@ void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, double Rst, double Red, int delt
 		rotateMat.block(1, 3, 1, 3, rotateMat);
 	} else rotateMat.E(3);
 	// 画圆台
-	Mat<> stPoint, edPoint, preStPoint, preEdPoint, deltaVector(3);
+	Mat<real> stPoint, edPoint, preStPoint, preEdPoint, deltaVector(3);
 	for (int i = 0; i <= delta; i++) {
 		deltaVector.set(
 			cos(i * 2.0 * PI / delta),
@@ -751,19 +823,19 @@ void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, double Rst, double Red, int delt
 		preEdPoint = edPoint;
 	}
 }
-void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, double R, int delta) {
+void GraphicsND::drawPipe(Mat<real>& st, Mat<real>& ed, double R, int delta) {
 	drawPipe(st, ed, R, R, delta);
 }
-void GraphicsND::drawPipe(Mat<>* p, int N, double R, int delta) {
+void GraphicsND::drawPipe(Mat<real>* p, int N, double R, int delta) {
 	for (int i = 0; i < N - 1; i++) drawPipe(p[i], p[i + 1], R, R, delta);
 }
-void GraphicsND::drawPipe(Mat<>& path, double R, int delta) {
-	Mat<> p1, p2; path.getCol(0, p1); p2 = p1;
+void GraphicsND::drawPipe(Mat<real>& path, double R, int delta) {
+	Mat<real> p1, p2; path.getCol(0, p1); p2 = p1;
 	for (int i = 0; i < path.cols; i++, p2 = p1) drawPipe(path.getCol(i, p1), p2, R, R, delta);
 }
-void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, Mat<>& f) {
+void GraphicsND::drawPipe(Mat<real>& st, Mat<real>& ed, Mat<real>& f) {
 	// 计算 Rotate Matrix
-	Mat<> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
+	Mat<real> direction, rotateAxis, rotateMat, zAxis(3), tmp; zAxis.set(0, 0, 1);
 	direction.sub(ed, st);
 	if (direction[0] != 0 || direction[1] != 0) {
 		rotate(
@@ -774,7 +846,7 @@ void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, Mat<>& f) {
 		rotateMat.block(1, 3, 1, 3, rotateMat);
 	} else rotateMat.E(3);
 	// 画圆台
-	Mat<> stPoint, edPoint, preStPoint, preEdPoint; tmp.alloc(3);
+	Mat<real> stPoint, edPoint, preStPoint, preEdPoint; tmp.alloc(3);
 	for (int i = 0; i <= f.cols; i++) {
 		tmp.mul(rotateMat, tmp.set(f(0, i), f(1, i), 0));
 		stPoint.add(st, tmp);
@@ -794,17 +866,17 @@ void GraphicsND::drawPipe(Mat<>& st, Mat<>& ed, Mat<>& f) {
 		preEdPoint = edPoint;
 	}
 }
-void GraphicsND::drawPipe(Mat<>& path, Mat<>& f) {
-	Mat<> p1, p2; path.getCol(0, p1); p2 = p1;
+void GraphicsND::drawPipe(Mat<real>& path, Mat<real>& f) {
+	Mat<real> p1, p2; path.getCol(0, p1); p2 = p1;
 	for (int i = 0; i < path.cols; i++, p2 = p1) drawPipe(path.getCol(i, p1), p2, f);
 }
 /******************************************************************************
 *                    画旋转体
 ******************************************************************************/
-void GraphicsND::drawRotator(Mat<>& zero, Mat<>& axis, Mat<>& f, int delta, double st, double ed) {
+void GraphicsND::drawRotator(Mat<real>& zero, Mat<real>& axis, Mat<real>& f, int delta, double st, double ed) {
 	//Rotate f
-	Mat<> p1(3), p2(3), p3(3), p4(3), ft = f, RotateMat, preRotateMat, RotateMat0, RotateMatTmp;
-	Mat<> rotateAxis, fAxis(3), tmp; fAxis.set(0, 1, 0);
+	Mat<real> p1(3), p2(3), p3(3), p4(3), ft = f, RotateMat, preRotateMat, RotateMat0, RotateMatTmp;
+	Mat<real> rotateAxis, fAxis(3), tmp; fAxis.set(0, 1, 0);
 	if (axis[0] != 0 || axis[2] != 0) {
 		rotate(
 			rotateAxis.cross(axis, fAxis),
@@ -843,8 +915,8 @@ void GraphicsND::drawRotator(Mat<>& zero, Mat<>& axis, Mat<>& f, int delta, doub
 /******************************************************************************
 *                    画阶梯
 ******************************************************************************/
-void GraphicsND::drawStairs(Mat<>& zero, double Length, double Width, double Height, int StairsNum) {
-	Mat<> p1(3), p2(3);
+void GraphicsND::drawStairs(Mat<real>& zero, double Length, double Width, double Height, int StairsNum) {
+	Mat<real> p1(3), p2(3);
 	for (int i = 0; i < StairsNum; i++)
 		drawCuboid(
 			p1.set(0,       i      * Width / StairsNum,  i      * Height / StairsNum) += zero,
@@ -854,17 +926,17 @@ void GraphicsND::drawStairs(Mat<>& zero, double Length, double Width, double Hei
 /******************************************************************************
 *                    画阶梯
 ******************************************************************************/
-void GraphicsND::drawChar(Mat<>& p0, char charac) {
+void GraphicsND::drawChar(Mat<real>& p0, char charac) {
 	Mat<int> p; value2pix(p0, p);	g.drawChar	(g.Canvas.rows / 2 - p[1], g.Canvas.cols / 2 + p[0], charac);
 }
-void GraphicsND::drawString(Mat<>& p0, const char* str) {
+void GraphicsND::drawString(Mat<real>& p0, const char* str) {
 	Mat<int> p; value2pix(p0, p);	g.drawString(g.Canvas.rows / 2 - p[1], g.Canvas.cols / 2 + p[0], str);
 }
-void GraphicsND::drawNum(Mat<>& p0, double num) {
+void GraphicsND::drawNum(Mat<real>& p0, double num) {
 	Mat<int> p; value2pix(p0, p);	g.drawNum	(g.Canvas.rows / 2 - p[1], g.Canvas.cols / 2 + p[0], num);
 }
 /*--------------------------------[ 画线 any-D ]--------------------------------*/
-void GraphicsND::drawSuperLine(Mat<>* p0) {
+void GraphicsND::drawSuperLine(Mat<real>* p0) {
 
 }
 /******************************************************************************
@@ -877,9 +949,9 @@ void GraphicsND::drawSuperLine(Mat<>* p0) {
 		[1] 以二进制顺序遍历所有顶点
 			[2] 连接该点和所有比该点编码多1的点
 ******************************************************************************/
-void GraphicsND::drawSuperCuboid(Mat<>& pMin, Mat<>& pMax) {
+void GraphicsND::drawSuperCuboid(Mat<real>& pMin, Mat<real>& pMax) {
 	unsigned int Dim = pMin.rows, maxCode = 0;
-	Mat<> st, ed;
+	Mat<real> st, ed;
 	for (int i = 0; i < Dim; i++) maxCode += 1 << i;
 	for (unsigned int code = 0; code < maxCode; code++) {
 		st = pMin;
@@ -901,10 +973,10 @@ void GraphicsND::drawSuperCuboid(Mat<>& pMin, Mat<>& pMax) {
 *	[定义]: 球: 距离圆心距离为R的点的集合. Σdim_i² = R²
 *	[算法]: 计算正象限的点坐标，然后通过取负绘制其他象限.
 ******************************************************************************/
-void GraphicsND::drawSuperSphere(Mat<>& center, double r) {
+void GraphicsND::drawSuperSphere(Mat<real>& center, double r) {
 	unsigned int Dim = center.rows, maxCode = 0, times = 1, cur;
 	double delta = 0.1, tmp;
-	Mat<> point(Dim), tmpMat;
+	Mat<real> point(Dim), tmpMat;
 	for (int dim = 0; dim < Dim; dim++) { times *= 1.0 / delta + 1; maxCode += 1 << dim; }
 	for (int i = 0; i < times; i++) {
 		//[1] 计算正象限的点坐标
@@ -928,8 +1000,8 @@ void GraphicsND::drawSuperSphere(Mat<>& center, double r) {
 		}
 	}
 }
-void GraphicsND::draw4DSphere(Mat<>& center, double r) {
-	Mat<> point(4), pointU(4), pointL(4), pointUL(4);
+void GraphicsND::draw4DSphere(Mat<real>& center, double r) {
+	Mat<real> point(4), pointU(4), pointL(4), pointUL(4);
 	point[3] = pointU[3] = pointL[3] = pointUL[3] = center[3] - r;
 	double delta = 36, dz = r / 3;
 	double dAngle = 2.0 * PI / delta;
@@ -972,10 +1044,10 @@ void GraphicsND::draw4DSphere(Mat<>& center, double r) {
 		[1] 计算每一个格点的坐标
 		[2] 绘制该格点对应的, 各维度方向的从min[dim] -> max[dim]的直线段
 ---------------------------------------------------------------------------*/
-void GraphicsND::drawGrid(Mat<>& delta, Mat<>& max, Mat<>& min) {
+void GraphicsND::drawGrid(Mat<real>& delta, Mat<real>& max, Mat<real>& min) {
 	int times = 1, cur;
 	for (int dim = 0; dim < min.rows; dim++) times *= (max[dim] - min[dim]) / delta[dim] + 1;
-	Mat<> point(min), st, ed; point[0] -= delta[0];
+	Mat<real> point(min), st, ed; point[0] -= delta[0];
 	for (int i = 0; i < times; i++) {
 		//[1]
 		cur = 0; point[cur] += delta[cur];
@@ -1005,7 +1077,7 @@ void GraphicsND::drawAxis(double Xmax,double Ymax,double Zmax, bool negative) {
 	drawLine(0, 0, negative ? -Ymax : 0, Ymax);//y
 	drawLine(0, 0, 0, 0, negative ? -Zmax : 0, Zmax);//z
 	// 箭头
-	Mat<> st(3), ed(3);
+	Mat<real> st(3), ed(3);
 	int vectorLength = 10, 
 		vectorWidth  = vectorLength / 2.718281828456;
 	st.set(Xmax, 0, 0);
@@ -1019,7 +1091,7 @@ void GraphicsND::drawAxis(double Xmax,double Ymax,double Zmax, bool negative) {
 	if (Zmax != 0) drawFrustum(st, ed, vectorWidth, 0, 45);
 }
 /*--------------------------------[ 画等高线 ]--------------------------------*/
-void GraphicsND::contour(Mat<>& map, const int N) {
+void GraphicsND::contour(Mat<real>& map, const int N) {
 	int x_step[] = { 1,0,1 }, 
 		y_step[] = { 0,1,1 };
 	double max = map.max(),
@@ -1047,13 +1119,13 @@ void GraphicsND::contour(Mat<>& map, const int N) {
 		}
 	}
 }
-void GraphicsND::contour(Mat<>& map) {
+void GraphicsND::contour(Mat<real>& map) {
 	double min = map.min(),
 		 delta = map.max() - min;
 	for (int i = 0; i < map.size(); i++)
 		g.setPoint(map.i2x(i), map.i2y(i), colorlist((map[i] - min) / delta, 1));
 }
-void GraphicsND::contour(Mat<>& mapX, Mat<>& mapY, Mat<>& mapZ) {
+void GraphicsND::contour(Mat<real>& mapX, Mat<real>& mapY, Mat<real>& mapZ) {
 	double 
 		minX = mapX.min(), maxX = mapX.max(),
 		minY = mapY.min(), maxY = mapY.max(),
@@ -1099,8 +1171,8 @@ ARGB GraphicsND::colorlist(double index, int model)
 	|y'|   |dy  0  1  0 | |y|
 	|z'|   |dz  0  0  1 | |z|
 ******************************************************************************/
-Mat<>& GraphicsND::translate(Mat<>& delta, Mat<>& transMat) {
-	Mat<> translateMat; translateMat.E(transMat.rows);
+Mat<GraphicsND::real>& GraphicsND::translate(Mat<real>& delta, Mat<real>& transMat) {
+	Mat<real> translateMat; translateMat.E(transMat.rows);
 	for (int i = 0; i < delta.rows; i++) translateMat(i + 1, 0) = delta[i];
 	return transMat.mul(translateMat, transMat);
 }
@@ -1123,9 +1195,9 @@ Mat<>& GraphicsND::translate(Mat<>& delta, Mat<>& transMat) {
 				[d  c -b  a]
 **--------------------------------------------------------------------------*/
 //2D S02
-Mat<>& GraphicsND::rotate(double theta, Mat<>& center, Mat<>& transMat) {
+Mat<GraphicsND::real>& GraphicsND::rotate(double theta, Mat<real>& center, Mat<real>& transMat) {
 	if (transMat.rows - 1 != 2) exit(-1);
-	Mat<> tmp, rotateMat;
+	Mat<real> tmp, rotateMat;
 	translate(center.negative(tmp), transMat);
 	// rotate
 	transMat.mul( rotateMat.E(transMat.rows) = {
@@ -1136,12 +1208,12 @@ Mat<>& GraphicsND::rotate(double theta, Mat<>& center, Mat<>& transMat) {
 	return translate(center, transMat);
 }
 //3D S03·四元数
-Mat<>& GraphicsND::rotate(Mat<>& rotateAxis, double theta, Mat<>& center, Mat<>& transMat) {
+Mat<GraphicsND::real>& GraphicsND::rotate(Mat<real>& rotateAxis, double theta, Mat<real>& center, Mat<real>& transMat) {
 	if (transMat.rows - 1 != 3) exit(-1);
-	Mat<> tmp;
+	Mat<real> tmp;
 	translate(center.negative(tmp), transMat);
 	rotateAxis.normalize();
-	Mat<> q(transMat.rows);				//四元数
+	Mat<real> q(transMat.rows);				//四元数
 	q = {
 		cos(theta / 2),
 		sin(theta / 2) * rotateAxis[0],
@@ -1149,7 +1221,7 @@ Mat<>& GraphicsND::rotate(Mat<>& rotateAxis, double theta, Mat<>& center, Mat<>&
 		sin(theta / 2) * rotateAxis[2]
 	};
 	// rotate mat
-	Mat<> rotateMat; rotateMat.zero(transMat);
+	Mat<real> rotateMat; rotateMat.zero(transMat);
 	for (int i = 0; i < 4; i++) for (int j = 0; j < 4; j++) rotateMat(i, j) = q[((j % 2 == 0 ? 1 : -1) * i + j + 4) % 4];
 	for (int i = 1; i < 4; i++) rotateMat(i, i % 3 + 1) *= -1;
 	tmp = rotateMat;
@@ -1160,13 +1232,13 @@ Mat<>& GraphicsND::rotate(Mat<>& rotateAxis, double theta, Mat<>& center, Mat<>&
 	return translate(center, transMat.mul(rotateMat, transMat));
 }
 //4D S04
-Mat<>& GraphicsND::rotate(Mat<>& rotateAxis1, Mat<>& rotateAxis2, double theta1, double theta2, Mat<>& center, Mat<>& transMat) {
+Mat<GraphicsND::real>& GraphicsND::rotate(Mat<real>& rotateAxis1, Mat<real>& rotateAxis2, double theta1, double theta2, Mat<real>& center, Mat<real>& transMat) {
 	if (transMat.rows - 1 != 4) exit(-1);
-	Mat<> tmp, rotateMat; rotateMat.zero(transMat);
+	Mat<real> tmp, rotateMat; rotateMat.zero(transMat);
 	translate(center.negative(tmp), transMat);
 	double c1 = cos(theta1), s1 = sin(theta1),
 	       c2 = cos(theta2), s2 = sin(theta2);
-	Mat<> q[4], t1(4);
+	Mat<real> q[4], t1(4);
 	q[0].zero(4) = { c1,s1,c2,s2 };
 	q[1].zero(4) = { c1,0 ,0 ,s2 };
 	q[2].zero(4) = { 0 ,s1,0 ,s2 };
@@ -1192,11 +1264,11 @@ Mat<>& GraphicsND::rotate(Mat<>& rotateAxis1, Mat<>& rotateAxis2, double theta1,
 |y'|   | 0  0 sy  0 | |y|
 |z'|   | 0  0  0 sz | |z|
 **-----------------------------------------------------------------------*/
-Mat<>& GraphicsND::scale(Mat<>& ratio, Mat<>& center, Mat<>& transMat) {
-	Mat<> tmp;
+Mat<GraphicsND::real>& GraphicsND::scale(Mat<real>& ratio, Mat<real>& center, Mat<real>& transMat) {
+	Mat<real> tmp;
 	translate(center.negative(tmp), transMat);
 	// scale
-	Mat<> scaleMat; scaleMat.E(transMat.rows);
+	Mat<real> scaleMat; scaleMat.E(transMat.rows);
 	for (int i = 0; i < ratio.rows; i++)scaleMat(i + 1, i + 1) = ratio[i];
 	transMat.mul(scaleMat, transMat);
 	return translate(center, transMat);
@@ -1204,7 +1276,7 @@ Mat<>& GraphicsND::scale(Mat<>& ratio, Mat<>& center, Mat<>& transMat) {
 void GraphicsND::interactive() {
 	int ch;
 	static int v = 1;
-	static Mat<> delta(3), zero(3);
+	static Mat<real> delta(3), zero(3);
 	if (_kbhit()) {
 		ch = _getch(); printf("%d ", ch);
 		if (ch == 'a') translate(delta.set( v, 0, 0));
@@ -14,20 +14,23 @@ limitations under the License.
 #define GRAPHICS_ND_H
 #include "Graphics.h"
 #include "GraphicsFileCode.h"
+#include "GraphicsReal.h"
 #include <conio.h>
 #define PI 3.141592653589
 class GraphicsND
 {
 public:
+	typedef GRAPHICS_REAL real;
 	/*---------------- 基础参数 ----------------*/
 	Graphics g;																//核心图形学类
 	Mat<Mat<int>> Z_Buffer;
-	static Mat<> TransformMat;												//变换矩阵
+	static Mat<real> TransformMat;												//变换矩阵
 	static unsigned int FaceColor;
-	unsigned int(*FaceColorF)(Mat<>& p1, Mat<>& p2, Mat<>& p3) = FaceColorF_1;
+	unsigned int(*FaceColorF)(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3) = FaceColorF_1;
 	double perspective = 0;
-	std::vector<Mat<>> LineSet, TriangleSet;
+	std::vector<Mat<real>> LineSet, TriangleSet;
 	bool FACE = true, LINE = false,
+		 ANTIALIAS = false,												//反走样直线 (3D)
 		 isLineTriangleSet = false;
 	/*---------------- 底层 ----------------*/
    ~GraphicsND() { ; }														//析构函数
@@ -35,81 +38,83 @@ public:
 	void init (int width, int height, int Dim = 3);							//初始化
 	void clear(ARGB color);													//清屏
 	void value2pix	(double x0, double y0, double z0, int& x, int& y, int& z);//点To像素 (<=3D)
-	void value2pix	(Mat<>& p0, Mat<int>& pAns);							//点To像素 (anyD)
+	void value2pix	(double x0, double y0, double z0, double& x, double& y, double& z);//点To像素 (3D, 浮点)
+	void value2pix	(Mat<real>& p0, Mat<int>& pAns);							//点To像素 (anyD)
 	bool setPix		(int x, int y, int z = 0, int size = -1, unsigned int color = 0);	//写像素 (<=3D)
 	bool setPix		(Mat<int>& p0,            int size = -1, unsigned int color = 0);	//写像素 (anyD)
-	void setAxisLim	(Mat<>& pMin, Mat<>& pMax);								//设置坐标范围
+	void setAxisLim	(Mat<real>& pMin, Mat<real>& pMax);								//设置坐标范围
 	void writeModel (const char* fileName);									//写模型文件
-	static unsigned int FaceColorF_1(Mat<>& p1, Mat<>& p2, Mat<>& p3);
-	static unsigned int FaceColorF_2(Mat<>& p1, Mat<>& p2, Mat<>& p3);
-	static unsigned int FaceColorF_3(Mat<>& p1, Mat<>& p2, Mat<>& p3);
+	static unsigned int FaceColorF_1(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3);
+	static unsigned int FaceColorF_2(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3);
+	static unsigned int FaceColorF_3(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3);
 	/*---------------- DRAW ----------------*/
 	// 0-D
 	void drawPoint		(double x0 = 0, double y0 = 0, double z0 = 0);		//画点 (<=3D)
-	void drawPoint		(Mat<>& p0);										//画点 (anyD)
+	void drawPoint		(Mat<real>& p0);										//画点 (anyD)
 	// 1-D
 	void drawLine		(double sx0 = 0, double ex0 = 0, 
 						 double sy0 = 0, double ey0 = 0, 
 						 double sz0 = 0, double ez0 = 0);					//画直线 (<=3D)
-	void drawLine		(Mat<>& sp0, Mat<>& ep0);							//画直线 (anyD)
-	void drawPolyline	(Mat<>* p, int n, bool close = false);				//画折线
-	void drawBezierLine	(Mat<> p[], int n);									//画Bezier曲线
+	void drawLine		(Mat<real>& sp0, Mat<real>& ep0);							//画直线 (anyD)
+	void drawLineAA		(double sx0, double ex0, double sy0, double ey0, double sz0, double ez0);	//反走样直线 (3D)
+	void drawPolyline	(Mat<real>* p, int n, bool close = false);				//画折线
+	void drawBezierLine	(Mat<real> p[], int n);									//画Bezier曲线
 	// 2-D
-	void drawTriangle	(Mat<>& p1, Mat<>& p2, Mat<>& p3);					//画三角形
-	void drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3);					//画三角形集
-	void drawTriangleSet(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>&FaceVec);	//画三角形集
-	void drawRectangle	(Mat<>& sp, Mat<>& ep, Mat<>* direct = NULL);		//画矩形
-	void drawQuadrangle	(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4);		//画四边形
-	void drawPolygon	(Mat<> p[], int n);									//画多边形
-	void drawCircle		(Mat<>& center, double r, double delta = 36,								 Mat<>* direct = NULL);		//画圆
-	void drawSector		(Mat<>& center, double r, double angleSt, double angleEd, double delta = 36, Mat<>* direct = NULL);		//画扇形
-	void drawEllipse	(Mat<>& center, double rx, double ry,										 Mat<>* direct = NULL);		//画椭圆
-	void drawSurface	(Mat<>& z, double xs, double xe, double ys, double ye, Mat<>* direct = NULL);		//画曲面
-	void drawBezierFace	(Mat<> p[], int n);									//画Bezier曲面
+	void drawTriangle	(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3);					//画三角形
+	void drawTriangleSet(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3);					//画三角形集
+	void drawTriangleSet(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>&FaceVec);	//画三角形集
+	void drawRectangle	(Mat<real>& sp, Mat<real>& ep, Mat<real>* direct = NULL);		//画矩形
+	void drawQuadrangle	(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>& p4);		//画四边形
+	void drawPolygon	(Mat<real> p[], int n);									//画多边形
+	void drawCircle		(Mat<real>& center, double r, double delta = 36,								 Mat<real>* direct = NULL);		//画圆
+	void drawSector		(Mat<real>& center, double r, double angleSt, double angleEd, double delta = 36, Mat<real>* direct = NULL);		//画扇形
+	void drawEllipse	(Mat<real>& center, double rx, double ry,										 Mat<real>* direct = NULL);		//画椭圆
+	void drawSurface	(Mat<real>& z, double xs, double xe, double ys, double ye, Mat<real>* direct = NULL);		//画曲面
+	void drawBezierFace	(Mat<real> p[], int n);									//画Bezier曲面
 	// 3-D
-	void drawTetrahedron(Mat<>& p1, Mat<>& p2, Mat<>& p3, Mat<>& p4);		//画四面体
-	void drawCuboid		(Mat<>&pMin,Mat<>& pMax);							//画矩体
-	void drawPolyhedron	(Mat<>* p, int n);									//画多面体
-	void drawGoldbergPolyhedron	(Mat<>&, int m, int n);						//画Goldberg多面体(五,六边形密铺球)
-	void drawFrustum	(Mat<>& st, Mat<>& ed, double Rst, double Red, double delta = 36);	//画圆台
-	void drawCylinder	(Mat<>& st, Mat<>& ed, double r, double delta = 36);//画圆柱
-	void drawSphere		(Mat<>& center, double r, double dAngle = 2 * PI / 36);			//画球
-	void drawSphere		(Mat<>& center, double r, double thetaSt, double thetaEd, 
+	void drawTetrahedron(Mat<real>& p1, Mat<real>& p2, Mat<real>& p3, Mat<real>& p4);		//画四面体
+	void drawCuboid		(Mat<real>&pMin,Mat<real>& pMax);							//画矩体
+	void drawPolyhedron	(Mat<real>* p, int n);									//画多面体
+	void drawGoldbergPolyhedron	(Mat<real>&, int m, int n);						//画Goldberg多面体(五,六边形密铺球)
+	void drawFrustum	(Mat<real>& st, Mat<real>& ed, double Rst, double Red, double delta = 36);	//画圆台
+	void drawCylinder	(Mat<real>& st, Mat<real>& ed, double r, double delta = 36);//画圆柱
+	void drawSphere		(Mat<real>& center, double r, double dAngle = 2 * PI / 36);			//画球
+	void drawSphere		(Mat<real>& center, double r, double thetaSt, double thetaEd, 
 							double phiSt = -PI / 2, double phiEd = PI / 2, double dAngle = 2*PI/36);//画部分球
-	void drawSphere2	(Mat<>& center, double r, int n = 300);				//画球
-	void drawEllipsoid	(Mat<>& center, Mat<>& r);							//画椭球
-	void drawBody		(Mat<>& center, Mat<>& r);							//画曲体
-	void drawBezierBody	(Mat<> p[], int n);									//画Bezier曲体
-	void drawPipe		(Mat<>& st, Mat<>& ed, double Rst, double Red, int delta = 36);	//画平移体(粗细正多边形截面,线段路径)
-	void drawPipe		(Mat<>& st, Mat<>& ed, double R,               int delta = 36);	//画平移体(正多边形截面,线段路径)
-	void drawPipe		(Mat<>* p,  int N,	   double R,			   int delta = 36);	//画平移体(正多边形截面,any路径)
-	void drawPipe		(Mat<>& path,		   double R,			   int delta = 36);	//画平移体(正多边形截面,any路径)
-	void drawPipe		(Mat<>& st, Mat<>& ed, Mat<>& f);								//画平移体(any截面,线段路径)
-	void drawPipe		(Mat<>& path, Mat<>& f);										//画平移体(any截面,any路径)
-	void drawRotator	(Mat<>& zero, Mat<>& axis, Mat<>& f, int delta = 36, double st = 0, double ed = 2 * PI);	//画旋转体
-	void drawStairs		(Mat<>& zero, double Length, double Width, double Height, int Num);	//画阶梯
+	void drawSphere2	(Mat<real>& center, double r, int n = 300);				//画球
+	void drawEllipsoid	(Mat<real>& center, Mat<real>& r);							//画椭球
+	void drawBody		(Mat<real>& center, Mat<real>& r);							//画曲体
+	void drawBezierBody	(Mat<real> p[], int n);									//画Bezier曲体
+	void drawPipe		(Mat<real>& st, Mat<real>& ed, double Rst, double Red, int delta = 36);	//画平移体(粗细正多边形截面,线段路径)
+	void drawPipe		(Mat<real>& st, Mat<real>& ed, double R,               int delta = 36);	//画平移体(正多边形截面,线段路径)
+	void drawPipe		(Mat<real>* p,  int N,	   double R,			   int delta = 36);	//画平移体(正多边形截面,any路径)
+	void drawPipe		(Mat<real>& path,		   double R,			   int delta = 36);	//画平移体(正多边形截面,any路径)
+	void drawPipe		(Mat<real>& st, Mat<real>& ed, Mat<real>& f);								//画平移体(any截面,线段路径)
+	void drawPipe		(Mat<real>& path, Mat<real>& f);										//画平移体(any截面,any路径)
+	void drawRotator	(Mat<real>& zero, Mat<real>& axis, Mat<real>& f, int delta = 36, double st = 0, double ed = 2 * PI);	//画旋转体
+	void drawStairs		(Mat<real>& zero, double Length, double Width, double Height, int Num);	//画阶梯
 	// Word
-	void drawChar		(Mat<>& p0, char charac);				//显示字符
-	void drawString		(Mat<>& p0, const char* str);			//显示字符串
-	void drawNum		(Mat<>& p0, double num);				//显示数字
+	void drawChar		(Mat<real>& p0, char charac);				//显示字符
+	void drawString		(Mat<real>& p0, const char* str);			//显示字符串
+	void drawNum		(Mat<real>& p0, double num);				//显示数字
 	// any-D
-	void drawSuperLine	(Mat<>* p0);							//画线 any-D
-	void drawSuperCuboid(Mat<>& pMin, Mat<>& pMax);				//画立方体 any-D
-	void drawSuperSphere(Mat<>& center, double r);				//画球体 any-D
-	void draw4DSphere(Mat<>& center, double r);				//画球体 any-D
-	void drawGrid		(Mat<>& delta, Mat<>& max, Mat<>& min);	//画网格
+	void drawSuperLine	(Mat<real>* p0);							//画线 any-D
+	void drawSuperCuboid(Mat<real>& pMin, Mat<real>& pMax);				//画立方体 any-D
+	void drawSuperSphere(Mat<real>& center, double r);				//画球体 any-D
+	void draw4DSphere(Mat<real>& center, double r);				//画球体 any-D
+	void drawGrid		(Mat<real>& delta, Mat<real>& max, Mat<real>& min);	//画网格
 	// Other
 	void drawAxis(double Xmax = 0, double Ymax = 0, double Zmax = 0, bool negative = false);						//画坐标轴
-	void contour	(Mat<>& map, const int N);																		//画等高线
-	void contour	(Mat<>& map);																					//画等高面
-	void contour	(Mat<>& mapX, Mat<>& mapY, Mat<>& mapZ);
+	void contour	(Mat<real>& map, const int N);																		//画等高线
+	void contour	(Mat<real>& map);																					//画等高面
+	void contour	(Mat<real>& mapX, Mat<real>& mapY, Mat<real>& mapZ);
 	ARGB colorlist(double index, int model = 1);																	//色谱
 	/*---------------- 几何变换 Transformation ----------------*/
-	static Mat<>& translate	(Mat<>& delta,										Mat<>& transMat = TransformMat);	//平移
-	static Mat<>& rotate	(double theta, Mat<>& center,						Mat<>& transMat = TransformMat);	//旋转 2D
-	static Mat<>& rotate	(Mat<>& rotateAxis, double theta, Mat<>& center,	Mat<>& transMat = TransformMat);	//旋转 3D
-	static Mat<>& rotate	(Mat<>& rotateAxis1, Mat<>& rotateAxis2, double theta1, double theta2,Mat<>& center,Mat<>& transMat = TransformMat);	//旋转 4D
-	static Mat<>& scale		(Mat<>& ratio, Mat<>& center,						Mat<>& transMat = TransformMat);	//缩放
+	static Mat<real>& translate	(Mat<real>& delta,										Mat<real>& transMat = TransformMat);	//平移
+	static Mat<real>& rotate	(double theta, Mat<real>& center,						Mat<real>& transMat = TransformMat);	//旋转 2D
+	static Mat<real>& rotate	(Mat<real>& rotateAxis, double theta, Mat<real>& center,	Mat<real>& transMat = TransformMat);	//旋转 3D
+	static Mat<real>& rotate	(Mat<real>& rotateAxis1, Mat<real>& rotateAxis2, double theta1, double theta2,Mat<real>& center,Mat<real>& transMat = TransformMat);	//旋转 4D
+	static Mat<real>& scale		(Mat<real>& ratio, Mat<real>& center,						Mat<real>& transMat = TransformMat);	//缩放
 	/*---------------- 交互 ----------------*/
 	void interactive();
 };
@@ -0,0 +1,19 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef GRAPHICS_REAL_H
+#define GRAPHICS_REAL_H
+/*---------------- 标量类型: 图形学点坐标/变换矩阵/累加缓冲的精度, 编译时 -DGRAPHICS_REAL=float 切换为单精度 ----------------*/
+#ifndef GRAPHICS_REAL
+#define GRAPHICS_REAL double
+#endif
+#endif
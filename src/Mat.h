@@ -19,8 +19,26 @@ limitations under the License.
 #include <string.h>
 #include <math.h>
 #include <initializer_list>
-template<class T = double>
-class Mat
+#include <type_traits>
+#include "Parallel.h"
+#include "MatArena.h"
+/******************************************************************************
+*                    Mat<T, R, C>
+*	R == 0 (默认): 动态尺寸矩阵, 数据存于堆.
+*	R >  0       : 定长矩阵, 尺寸为编译期常量, 数据存于栈. (见文件末 [定长矩阵])
+******************************************************************************/
+template<class T = double, int R = 0, int C = 1> class Mat;
+template<class E> struct MatExpr;
+template<class T = double> struct MatView;
+template<class T> struct MatGemm;
+template<class T> struct MatConv;
+template<class T> struct MatLU;
+template<class T> struct MatEig;
+/*---------------- 累加类型: 求和/点乘的块内累加精度, float 以 double 累加 ----------------*/
+template<class T> struct MatAccum		{ typedef T type; };
+template<>		  struct MatAccum<float> { typedef double type; };
+template<class T>
+class Mat<T, 0, 1>
 {
 public:
 /******************************************************************************
@@ -28,6 +46,9 @@ public:
 ******************************************************************************/
 	T* data = NULL;													//数据堆叠方向: 行优先
 	int rows = 0, cols = 0;
+	int capacity = 0;												//已分配元素数, >= rows * cols
+	MatArena* arena = NULL;											//数据来源内存池, NULL: 堆
+	enum { PARALLEL_N = 1 << 15, REDUCE_BLOCK = 1 << 12 };			//元素数不少于 PARALLEL_N 时并行; 归约分块长度
 /******************************************************************************
 *                    基础函数
 -------------------------------------------------------------------------------
@@ -35,31 +56,45 @@ Mat();                                      //构造/析构函数
 Mat(const int _rows, const int _cols);
 Mat(const int _rows);
 Mat(const Mat& a);
+Mat(Mat&& a);								//移动构造/赋值
+Mat& operator=(Mat&& a);
 ~Mat();
 void error();								//报错
 int  size();								//Size
 Mat& fill(T a);								//填充
 void eatMat(Mat& a);						//吃掉另一个矩阵(指针操作)
 void swap(Mat& a);							//交换数据 [ swap ]
+Mat& reserve(int n);						//预留空间
+void release();								//释放空间 (堆或 MatArena)
 ******************************************************************************/
 	/*---------------- 构造/析构函数 ----------------*/
 	Mat() { ; }
 	Mat(const int _rows, const int _cols) { zero(_rows, _cols); }
 	Mat(const int _rows) { zero(_rows, 1); }
 	Mat(const Mat& a) { *this = a; }
-	Mat(const int _rows, const int _cols, T* _data) { zero(_rows, _cols); set(_data); }
-	~Mat() { delete data; }
+	Mat(Mat&& a) noexcept { eatMat(a); }
+	Mat(const int _rows, const int _cols, T* _data) { alloc(_rows, _cols); *this = _data; }
+	~Mat() { freeData(); }
 	/*---------------- 报错  ----------------*/
 	static void error() { exit(-1); }
 	/*---------------- Size  ----------------*/
 	inline int size() const { return rows * cols; }
 	/*---------------- 填充  ----------------*/
-	inline Mat& fill(T a) { for (int i = 0; i < size(); i++) data[i] = a; return *this; }
+	inline Mat& fill(T a) {
+		Parallel::parallelFor(size(), PARALLEL_N, [this, a](int st, int ed) {
+			T* __restrict d = data;
+			for (int i = st; i < ed; i++) d[i] = a;
+		});
+		return *this;
+	}
 	/*---------------- 吃掉另一个矩阵(指针操作)  ----------------*/
 	inline Mat& eatMat(Mat& a) {
-		if (data != NULL) delete data;
+		if (&a == this) return *this;
+		freeData();
 		data = a.data; a.data = NULL;
 		rows = a.rows; cols = a.cols; a.rows = a.cols = 0;
+		capacity = a.capacity; a.capacity = 0;
+		arena = a.arena; a.arena = NULL;
 		return *this;
 	}
 	/*----------------交换数据 [ swap ]----------------*/
@@ -67,8 +102,36 @@ void swap(Mat& a);							//交换数据 [ swap ]
 		T* tmp = a.data; a.data = data; data = tmp;
 		int t  = a.rows; a.rows = rows; rows = t;
 			t  = a.cols; a.cols = cols; cols = t;
+			t  = a.capacity; a.capacity = capacity; capacity = t;
+		MatArena* tmpArena = a.arena; a.arena = arena; arena = tmpArena;
+		return *this;
+	}
+	/*---------------- 预留空间 ----------------
+	*	容量至少为 n 个元素, 保留原数据; 此后 alloc 不超过容量时不再重新分配.
+	**-----------------------------------------*/
+	Mat& reserve(int n) {
+		if (n <= capacity) return *this;
+		MatArena* newArena = MatArena::active();
+		if (arena == NULL && newArena == NULL) {
+			data = (T*)realloc(data, n * sizeof(T));
+			capacity = n;
+			return *this;
+		}
+		T* newData = newArena ? (T*)newArena->alloc(n * sizeof(T)) : (T*)malloc(n * sizeof(T));
+		if (data != NULL) memcpy(newData, data, capacity * sizeof(T));
+		freeData();
+		data = newData; capacity = n; arena = newArena;
 		return *this;
 	}
+	/*---------------- 释放空间 ----------------*/
+	void release() {
+		freeData();
+		rows = cols = 0;
+	}
+	inline void freeData() {
+		if (arena != NULL) MatArena::release(data); else free(data);
+		data = NULL; arena = NULL; capacity = 0;
+	}
 /******************************************************************************
 *                    基础矩阵
 -------------------------------------------------------------------------------
@@ -78,14 +141,19 @@ void swap(Mat& a);							//交换数据 [ swap ]
 	[3]ones		全1元  
 	[4]rands	随机元 
 ******************************************************************************/
-	/*---------------- 分配空间 ----------------*/
+	/*---------------- 分配空间 ----------------
+	*	容量足够时复用原缓冲区 (内容不保证), 否则重新分配.
+	**-----------------------------------------*/
 	Mat& alloc(const int _rows, const int _cols = 1) {
-		if (_rows != rows || _cols != cols) {
-			if (data != NULL) delete data;
-			data = (T*)malloc(_rows * _cols * sizeof(T));
-			rows = _rows; 
-			cols = _cols;
-		} return *this;
+		if (_rows * _cols > capacity) {
+			freeData();
+			arena = MatArena::active();								//有 MatArena::Scope 时由内存池分配
+			data = arena ? (T*)arena->alloc(_rows * _cols * sizeof(T)) : (T*)malloc(_rows * _cols * sizeof(T));
+			capacity = _rows * _cols;
+		}
+		rows = _rows; 
+		cols = _cols;
+		return *this;
 	}
 	/*---------------- 零元/清零 ----------------*/
 	inline Mat& zero() { memset(data, 0, sizeof(T) * size()); return *this; }
@@ -142,6 +210,7 @@ T	 dot		(Mat& a, Mat& b);			//点乘 [dot ·]
 T	 dot		(Mat& a);
 Mat& crossProduct	(Mat& a, Mat& b);		//叉乘 [crossProduct ×]
 Mat& crossProduct_	(Mat& a, Mat& b);
+Mat& cross / cross_	(Mat& a, Mat& b);		//同上, 简写
 Mat& elementMul(Mat& a, Mat& b);			//元素乘 [elementMul ×]
 Mat& elementMul(Mat& a);
 Mat& elementDiv	(Mat& a, Mat& b);			//元素除 [elementDiv /]
@@ -150,24 +219,31 @@ Mat& negative	(Mat& ans);					//负 [negative -]
 Mat& transpose	(Mat& ans);					//转置 [transpose T]
 T	 sum		();							//求和 [sum Σ]
 T	 sum		(Mat& a);
+T	 sumKahan	();							//补偿求和
 Mat& sum		(Mat& ans,int dim);
 T	 product	();							//求积 [product Π]
 T	 norm		();							//范数 [norm ||x||]
 Mat& normalized	();							//归一化 [normalized]
+Mat& normalize	();
 T	 comi		(int i0, int j0);			//余子式 [comi]
 Mat& inv		(Mat& ans);					//取逆 [inv x~¹]
 T	 abs		();							//行列式 [abs |x|]
 Mat& adjugate	(Mat& ans);					//伴随矩阵 [adjugate A*]
-void eig		(T esp, Mat& eigvec, Mat& eigvalue);		//特征值特征向量 [eig]
+void eig		(T esp, Mat& eigvec, Mat& eigvalue, int k = 0);	//特征值特征向量 [eig]
 Mat& solveEquations		(Mat& b, Mat& x);					//解方程组 [solveEquations]
 void LUPdecomposition	(Mat& U, Mat& L, Mat<int>& P);		//LUP分解 [LUPdecomposition]
 Mat& diag		(Mat& ans);									//构造对角矩阵 [diag]
 Mat& conv		(Mat& a, Mat& b, int padding = 0, int stride = 1);	//卷积 [conv]
 Mat& function	(Mat& x, T (*f)(T))			//函数操作
 Mat& function	(T (*f)(T))
+Mat& map		(Mat& x, F&& f)				//并行映射/归约 [map/reduce]
+Mat& mapIndex	(Mat& x, F&& f)
+T	 reduce		(T init, F&& op)
+Mat& operator=	(const MatExpr<E>& e);		//表达式求值 [a + b * 2.0 - c]
 -------------------------------------------------------------------------------
 *	运算嵌套注意,Eg: b.add(b.mul(a, b), a.mul(-1, a));
-		不管括号第一二项顺序,都是数乘,乘法,加法, 问题原因暂不了解，别用该形式。
+		参数在调用前已求值, 且各自写回 b, a 本身, 故 add 读到的是已被改写的 b, a.
+		别用该形式, 改用表达式模板: b = a * b + a * -1; (见文件末 [表达式模板])
 * 	加减乘，即使是自己也不会影响，效率也不影响
 ******************************************************************************/
 	/*---------------- "[]" "()"取元素 ----------------
@@ -181,22 +257,14 @@ Mat& function	(T (*f)(T))
 	inline int  i2y (int i)			{ return i % cols; }
 	inline int xy2i (int x, int y)	{ return x * cols + y; }
 	/*---------------- max/min ----------------*/
-	T max() const {
-		T maxdata = *data;
-		for (int i = 1; i < size(); i++) maxdata = maxdata >= data[i] ? maxdata : data[i];
-		return maxdata;
-	}
+	T max() const { return reduce(*data, [](T a, T b) { return a >= b ? a : b; }); }
 	T max(int& index) {
 		T maxdata = *data; index = 0;
 		for (int i = 1; i < size(); i++)
 			if (maxdata < data[i]) { maxdata = data[i]; index = i; }
 		return maxdata;
 	}
-	T min() const {
-		T mindata = *data;
-		for (int i = 1; i < size(); i++) mindata = mindata <= data[i] ? mindata : data[i];
-		return mindata;
-	}
+	T min() const { return reduce(*data, [](T a, T b) { return a <= b ? a : b; }); }
 	T min(int& index) {
 		T mindata = *data; index = 0;
 		for (int i = 1; i < size(); i++)
@@ -247,11 +315,12 @@ Mat& function	(T (*f)(T))
 	}
 	/*----------------赋矩阵 [ = ]----------------*/ //不能赋值自己
 	Mat& operator=(const Mat& a) {
-		if (a.data == NULL) return *this;
+		if (a.data == NULL || &a == this) return *this;
 		alloc(a.rows, a.cols);
 		memcpy(data, a.data, sizeof(T) * size());
 		return *this;
 	}
+	Mat& operator=(Mat&& a) noexcept { return eatMat(a); }
 	Mat& operator=(T* a) { memcpy(data, a, sizeof(T) * size()); return *this; }
 	Mat& operator=(T  x) { return fill(x); }
 	Mat& operator=(std::initializer_list<T> list) { 
@@ -259,6 +328,51 @@ Mat& function	(T (*f)(T))
 		for (auto& item : list) data[i++] = item;
 		return *this;
 	}
+	/*----------------表达式求值 [ = += -= ]----------------
+	*	逐元素一次循环求值, 无中间矩阵.
+	*	表达式只含逐元素运算, 第i元只读各操作数第i元, 故自身可为操作数 (a = a * 2.0 + b).
+	**------------------------------------------------*/
+	template<class E> Mat(const MatExpr<E>& e) { *this = e; }
+	template<class E>
+	Mat& operator=(const MatExpr<E>& e) {
+		const E& x = e.self();
+		alloc(x.rows, x.cols);					//自身为操作数时尺寸必相同, 不会重新分配
+		for (int i = 0; i < size(); i++) data[i] = x[i];
+		return *this;
+	}
+	template<class E>
+	Mat& operator+=(const MatExpr<E>& e) {
+		const E& x = e.self();
+		if (x.rows != rows || x.cols != cols) error();
+		for (int i = 0; i < size(); i++) data[i] += x[i];
+		return *this;
+	}
+	template<class E>
+	Mat& operator-=(const MatExpr<E>& e) {
+		const E& x = e.self();
+		if (x.rows != rows || x.cols != cols) error();
+		for (int i = 0; i < size(); i++) data[i] -= x[i];
+		return *this;
+	}
+	/*----------------定长矩阵互操作 [ = += -= ]----------------*/
+	template<int R, int C>
+	typename std::enable_if<(R > 0), Mat&>::type operator=(const Mat<T, R, C>& a) {
+		alloc(R, C);
+		memcpy(data, a.data, sizeof(T) * R * C);
+		return *this;
+	}
+	template<int R, int C>
+	typename std::enable_if<(R > 0), Mat&>::type operator+=(const Mat<T, R, C>& a) {
+		if (R != rows || C != cols) error();
+		for (int i = 0; i < R * C; i++) data[i] += a.data[i];
+		return *this;
+	}
+	template<int R, int C>
+	typename std::enable_if<(R > 0), Mat&>::type operator-=(const Mat<T, R, C>& a) {
+		if (R != rows || C != cols) error();
+		for (int i = 0; i < R * C; i++) data[i] -= a.data[i];
+		return *this;
+	}
 	Mat& set(T x, T y) {
 		if (size() != 2) error();
 		data[0] = x;
@@ -272,12 +386,13 @@ Mat& function	(T (*f)(T))
 		data[2] = z;
 		return *this;
 	}
-	Mat& set(const char* fileName) {
+	Mat& set(const char* fileName) {								//文本读入; 大矩阵改用 MatFile.h 二进制读写/映射
 		FILE* fin = fopen(fileName, "r");
 		for (int i = 0; i < size(); i++) fscanf(fin, "%lf", &data[i]);
+		fclose(fin);
 		return *this;
 	}
-	Mat& set_(const int _rows, const int _cols, T* _data) { rows = _rows; cols = _cols; data = _data; return *this; }
+	Mat& set_(const int _rows, const int _cols, T* _data) { freeData(); rows = _rows; cols = _cols; data = _data; capacity = _rows * _cols; return *this; }	//接管 malloc 所得 _data
 	/*----------------加法 [ add + ]----------------*/
 	Mat& operator+=(Mat& a) {
 		if (a.rows != rows || a.cols != cols) error();
@@ -302,23 +417,29 @@ Mat& function	(T (*f)(T))
 		for (int i = 0; i < a.size(); i++) data[i] = a[i] - b[i];
 		return *this;
 	}
-	/*----------------乘法 [ mul × ]----------------*/
+	/*----------------乘法 [ mul × ]----------------
+	*	由 MatGemm 计算 (分块、打包、SIMD、大矩阵多线程), 见文件末 [矩阵乘法 GEMM]
+	**------------------------------------------------*/
 	Mat& mul(Mat& a, Mat& b) {
 		if (a.cols != b.rows) error();
 		Mat ansTmp(a.rows, b.cols);
-		for (int i = 0; i < a.rows; i++)
-			for (int j = 0; j < b.cols; j++) 
-				for (int k = 0; k < a.cols; k++) 
-					ansTmp(i, j) += a(i, k) * b(k, j);
+		MatGemm<T>::gemm(a.rows, b.cols, a.cols, a.data, b.data, ansTmp.data);
 		return eatMat(ansTmp);
 	}
 	Mat& operator*=(Mat& a) {
 		if (cols != a.rows) error();
 		Mat ansTmp(rows, a.cols);
-		for (int i = 0; i < rows; i++)
-			for (int j = 0; j < a.cols; j++) 
-				for (int k = 0; k < cols; k++)
-					ansTmp(i, j) += (*this)(i, k) * a(k, j);
+		MatGemm<T>::gemm(rows, a.cols, cols, data, a.data, ansTmp.data);
+		return eatMat(ansTmp);
+	}
+	Mat& mul(const MatView<T>& a, const MatView<T>& b) {		//视图: 行内连续时直接按行距计算, 否则先复制
+		if (a.cols != b.rows) error();
+		Mat ansTmp(a.rows, b.cols), ta, tb;
+		const T* pa = a.data; int lda = a.rowStride;
+		const T* pb = b.data; int ldb = b.rowStride;
+		if (a.colStride != 1) { a.toMat(ta); pa = ta.data; lda = ta.cols; }
+		if (b.colStride != 1) { b.toMat(tb); pb = tb.data; ldb = tb.cols; }
+		MatGemm<T>::gemm(a.rows, b.cols, a.cols, pa, lda, pb, ldb, ansTmp.data, ansTmp.cols);
 		return eatMat(ansTmp);
 	}
 	/*----------------数乘 [ mul × ]----------------*/
@@ -341,16 +462,16 @@ Mat& function	(T (*f)(T))
 	**------------------------------------------------*/
 	static T dot(Mat& a, Mat& b) {
 		if (a.rows != b.rows || a.cols != b.cols) error();
-		T ans = a[0] * b[0];
-		for (int i = 1; i < a.size(); i++) ans += a[i] * b[i];
-		return ans;
-	}
-	T dot(Mat& a) {
-		if (a.rows != rows && a.cols != cols) error();
-		T ans = data[0] * a[0];
-		for (int i = 1; i < size(); i++) ans += data[i] * a[i];
-		return ans;
-	}
+		typedef typename MatAccum<T>::type A;
+		const T* __restrict x = a.data, * __restrict y = b.data;
+		return (T)Parallel::parallelReduce(a.size(), REDUCE_BLOCK, PARALLEL_N / REDUCE_BLOCK, (A)0, [x, y](int st, int ed) {
+			A s0 = 0, s1 = 0, s2 = 0, s3 = 0; int i = st;
+			for (; i + 4 <= ed; i += 4) { s0 += (A)x[i] * y[i]; s1 += (A)x[i + 1] * y[i + 1]; s2 += (A)x[i + 2] * y[i + 2]; s3 += (A)x[i + 3] * y[i + 3]; }
+			for (; i < ed; i++) s0 += (A)x[i] * y[i];
+			return (s0 + s1) + (s2 + s3);
+		}, [](A a, A b) { return a + b; });
+	}
+	T dot(Mat& a) { return dot(*this, a); }
 	/*----------------叉乘 [ crossProduct × ]----------------
 	//####################### 暂时只三维
 	*	𝑎 × 𝑏 ⃑ = | 𝑥		𝑦	 𝑧  |
@@ -373,6 +494,8 @@ Mat& function	(T (*f)(T))
 		data[2] = a[0] * b[1] - a[1] * b[0];
 		return *this;
 	}
+	Mat& cross (Mat& a, Mat& b) { return crossProduct (a, b); }
+	Mat& cross_(Mat& a, Mat& b) { return crossProduct_(a, b); }
 	/*----------------元素乘 [ elementMul × ]----------------
 	**------------------------------------------------*/
 	Mat& elementMul(Mat& a, Mat& b) {
@@ -413,17 +536,34 @@ Mat& function	(T (*f)(T))
 				ansTmp(j, i) = (*this)(i, j);
 		return ans.eatMat(ansTmp);
 	}
-	/*----------------求和 [ sum Σ ]----------------*/
-	T sum() {
-		T ans = data[0];
-		for (int i = 1; i < size(); i++) ans += data[i];
-		return ans;
-	}
-	static T sum(Mat& a) {
-		T ans = a[0];
-		for (int i = 1; i < size(); i++) ans += a[i];
-		return ans;
+	/*----------------求和 [ sum Σ ]----------------
+	*	按 REDUCE_BLOCK 固定分块, 块内四路累加 (可向量化), 块间两两合并; 结果与线程数无关.
+	*	累加类型为 MatAccum<T>::type (float 以 double 累加), 结果再转回 T.
+	*	sumKahan: 块内 Kahan 补偿求和, 误差与元素数基本无关 (勿以 -ffast-math 编译, 否则补偿被优化掉).
+	**-------------------------------------------*/
+	T sum() const {
+		typedef typename MatAccum<T>::type A;
+		const T* __restrict a = data;
+		return (T)Parallel::parallelReduce(size(), REDUCE_BLOCK, PARALLEL_N / REDUCE_BLOCK, (A)0, [a](int st, int ed) {
+			A s0 = 0, s1 = 0, s2 = 0, s3 = 0; int i = st;
+			for (; i + 4 <= ed; i += 4) { s0 += a[i]; s1 += a[i + 1]; s2 += a[i + 2]; s3 += a[i + 3]; }
+			for (; i < ed; i++) s0 += a[i];
+			return (s0 + s1) + (s2 + s3);
+		}, [](A x, A y) { return x + y; });
+	}
+	T sumKahan() const {
+		typedef typename MatAccum<T>::type A;
+		const T* a = data;
+		return (T)Parallel::parallelReduce(size(), REDUCE_BLOCK, PARALLEL_N / REDUCE_BLOCK, (A)0, [a](int st, int ed) {
+			A s = 0, c = 0;
+			for (int i = st; i < ed; i++) {
+				A y = a[i] - c, t = s + y;
+				c = (t - s) - y; s = t;
+			}
+			return s;
+		}, [](A x, A y) { return x + y; });
 	}
+	static T sum(Mat& a) { return a.sum(); }
 	Mat& sum(Mat& ans,int dim) {
 		if (dim == 0) {				//对每一列求和
 			Mat ansTmp(1, cols);
@@ -442,11 +582,7 @@ Mat& function	(T (*f)(T))
 		error(); return ans;
 	}
 	/*----------------求积 [ product Π ]----------------*/
-	T product() {
-		T ans = data[0];
-		for (int i = 1; i < size(); i++) ans *= data[i];
-		return ans;
-	}
+	T product() const { return reduce((T)1, [](T a, T b) { return a * b; }); }
 	/*----------------范数 [ norm ||x|| ]----------------
 	*	||a|| = sqrt(a·a)
 	**-------------------------------------------*/
@@ -460,10 +596,12 @@ Mat& function	(T (*f)(T))
 		for (int i = 0; i < size(); i++) data[i] /= t;
 		return *this;
 	}
+	Mat& normalize() { return normalized(); }
 	/*----------------余子式 [ comi ]----------------
 	*	Mij: A 去掉第i行，第j列
 	**-----------------------------------------------*/
 	T comi(int i0, int j0) {
+		MatArena::Scope arenaScope;
 		Mat tmp(rows - 1, cols - 1);
 		for (int i = 0; i < rows; i++) {
 			for (int j = 0; j < cols; j++) {
@@ -475,35 +613,15 @@ Mat& function	(T (*f)(T))
 	}
 	/*----------------取逆 [ inv x~¹ ]----------------
 	*	[定义]: A A~¹ = E
-	*	[方法]: 利用不断解线性方程组，对每一列求解.
+	*	[方法]: 分块LU分解 (对称正定时为Cholesky) 后, 以单位阵为右端项同时求解各列. 见文件末 [LU分解]
 	**------------------------------------------*/
 	Mat& inv(Mat& ans) {
 		if (rows != cols)error();
-		Mat tmp(rows, cols);
-		int n = rows;
-		// LUP分解
-		Mat L, U; Mat<int> P;
-		LUPdecomposition(U, L, P);
-		//对每一列
-		Mat b(n), x(n);
-		for (int k = 0; k < n; k++) {
-			b.zero(); b[k] = 1;
-			// 解线性方程组
-			//solve y
-			for (int i = 0; i < n; i++) {
-				x[i] = b[P[i]];		//yi
-				for (int j = 0; j < i; j++) 
-					x[i] -= x[j] * L(i, j);
-			}
-			//solve x
-			for (int i = n - 1; i >= 0; i--) {
-				for (int j = i + 1; j < n; j++) 
-					x[i] -= x[j] * U(i, j);
-				x[i] /= U(i, i);
-			}
-			//合并至结果
-			for (int i = 0; i < rows; i++) tmp(i, k) = x[i];
-		}
+		Mat tmp;
+		tmp.E(rows);
+		MatArena::Scope arenaScope;				//tmp 之后的中间矩阵由内存池分配
+		Mat A(*this);
+		if (!MatLU<T>::solve(rows, A.data, cols, tmp.data)) error();	// singular matrix
 		return ans.eatMat(tmp);
 	}
 	/*----------------行列式 [ abs |x| ]----------------
@@ -518,33 +636,51 @@ Mat& function	(T (*f)(T))
 		if (rows != cols)error();
 		//加速
 		if (rows == 1)return data[0];
-		if (rows == 2)return (*this)(0, 0) * (*this)(1, 1) - (*this)(0, 1) * (*this)(0, 1);
+		if (rows == 2)return (*this)(0, 0) * (*this)(1, 1) - (*this)(0, 1) * (*this)(1, 0);
 		T ans; memset(&ans, 0, sizeof(T));
 		if (rows == 3) {
 			T t;
 			for (int i = 0; i < 3; i++) {
 				t = 1;
 				for (int j = 0; j < 3; j++) t *= (*this)(j,     (j + i) % 3); ans += t;
+				t = 1;
 				for (int j = 0; j < 3; j++) t *= (*this)(j, (2 - j + i) % 3); ans -= t;
 			} return ans;
 		}
-		//普适
+		//普适: 浮点 |A| = ±Π Uii (LU分解); 整数按余子式展开, 保证精确
+		if (std::is_floating_point<T>::value) {
+			MatArena::Scope arenaScope;
+			Mat A(*this);
+			return MatLU<T>::det(rows, A.data);
+		}
 		for (int i = 0; i < rows; i++)
 			ans += (*this)(i, 0) * (i % 2 == 0 ? 1 : -1) * comi(i, 0);
 		return ans;
 	}
 	/*--------------伴随矩阵 [ adjugate A* ]----------------
-	*	[定义]: 伴随矩阵A* 由(i,j)代数余子式Aij构成
-				 [ A00  ... ]
-			A* = | A01  Aij |
-				 [ A02  ... ]
-	*	[性质]: A* A = |A|
+	*	[定义]: 伴随矩阵A* 由(i,j)代数余子式Aij转置构成, 即 A*(j,i) = Aij
+				 [ A00  A10 ... ]
+			A* = | A01  A11 ... |
+				 [ A02  ... Aji ]
+	*	[性质]: A* A = A A* = |A| E
+	*	[算法]: 浮点 n > 3 且可逆时 A* = |A| A~¹ (LU); 否则逐个求代数余子式. 两者结果一致.
 	**---------------------------------------------*/
 	Mat& adjugate(Mat& ans) {
 		Mat ansTmp(rows, cols);
+		MatArena::Scope arenaScope;
+		if (std::is_floating_point<T>::value && rows == cols && rows > 3) {	//可逆时 A* = |A| A~¹
+			T d = abs();
+			if (d != 0) {
+				Mat A(*this);
+				ansTmp.E(rows);
+				MatLU<T>::solve(rows, A.data, cols, ansTmp.data);
+				for (int i = 0; i < ansTmp.size(); i++) ansTmp[i] *= d;
+				return ans.eatMat(ansTmp);
+			}
+		}
 		for (int i = 0; i < rows; i++)
 			for (int j = 0; j < cols; j++)
-				ansTmp(i, j) = ((i + j) % 2 == 0 ? 1 : -1) * comi(i, j);
+				ansTmp(j, i) = ((i + j) % 2 == 0 ? 1 : -1) * comi(i, j);
 		return ans.eatMat(ansTmp);
 	}
 	/*----------------特征值特征向量 [ eig ]----------------
@@ -553,7 +689,10 @@ Mat& function	(T (*f)(T))
 	*	[性质]:
 	*		若 R 为正交矩阵 (R'R = E),有B = R~¹A R , 使得 BY = λY, 特征值不变.
 	*				又有 X = R Y.
-	*	[算法]: 雅可比迭代:
+	*	[输出]: eigvec 各列为特征向量, eigvalue 为对角阵, 对角元为对应特征值.
+	*	[对称矩阵]: Householder 三对角化 + 隐式QL, 特征值降序; k > 0 时只求最大的 k 个特征对,
+	*		eigvec 为 n x k, eigvalue 为 k x k. 见文件末 [对称特征分解]. 此时 esp 不用.
+	*	[非对称矩阵]: 雅可比迭代:
 	*	* 原理:
 	*		对于目标实矩阵A, 构造正交矩阵序列 R1, R2, ... , Rn，
 	*			D0 = A
@@ -579,13 +718,17 @@ Mat& function	(T (*f)(T))
 			tan2Φ = (aqq - qpp) / apq = 2 * tanΦ / (1 - tan²Φ)
 			t² + 2tθ - 1 = 0
 	*------------------------------------------------*/
-	void eig(T esp, Mat& eigvec, Mat& eigvalue) {
+	void eig(T esp, Mat& eigvec, Mat& eigvalue, int k = 0) {
 		if (rows != cols)return;
+		if (MatLU<T>::isSymmetric(rows, data)) {
+			MatEig<T>::eig(*this, eigvec, eigvalue, k <= 0 || k > rows ? rows : k);
+			return;
+		}
 		//[1] init
 		int n = rows;
 		eigvalue = (*this);
 		eigvec.E(n);
-		Mat<> R, RT;
+		Mat R, RT;
 		//[2] begin iteration
 		while (true) {
 			//[3] Calculate row p and col q
@@ -617,9 +760,9 @@ Mat& function	(T (*f)(T))
 		}
 	}
 	/*----------------解方程组 [ solveEquations ]----------------
-	*	[定义]: A x = b
+	*	[定义]: A x = b			(b 可有多列, 各列同时求解)
 	*			ps.直接x = b A~¹ 会存在数值不稳定现象
-	*	[算法]: LUP分解
+	*	[算法]: LUP分解 (分块, 见文件末 [LU分解]; A 对称正定时为 Cholesky 分解 A = L Lᵀ)
 	*	[推导]
 			P A = L U
 			L: 单位下三角矩阵  U: 上三角矩阵  P: 置换矩阵
@@ -644,24 +787,12 @@ Mat& function	(T (*f)(T))
 						x = ( yi - Σ  uij xj ) / uii
 	**--------------------------------------------*/
 	Mat& solveEquations(Mat& b, Mat& x) {
-		int n = rows;
-		x.zero(n);
-		//[1] LUP分解
-		Mat U, L; Mat<int> P;
-		LUPdecomposition(U, L, P);
-		//[2] LUP - Solve  [3] solve y
-		for (int i = 0; i < n; i++) {
-			x[i] = b[P[i]];		//yi
-			for (int j = 0; j < i; j++) 
-				x[i] -= x[j] * L(i, j);
-		}
-		//[4] solve x
-		for (int i = n - 1; i >= 0; i--) {
-			for (int j = i + 1; j < n; j++) 
-				x[i] -= x[j] * U(i, j);
-			x[i] /= U(i, i);
-		}
-		return x;
+		if (rows != cols || b.rows != rows) error();
+		Mat xTmp(b);
+		MatArena::Scope arenaScope;
+		Mat A(*this);
+		if (!MatLU<T>::solve(rows, A.data, b.cols, xTmp.data)) error();	// singular matrix
+		return x.eatMat(xTmp);
 	}
 	/*----------------LUP分解 [ LUPdecomposition ]----------------
 	*	[定义]: P A = L U		其中 L: 单位下三角矩阵  U: 上三角矩阵  P: 置换矩阵
@@ -682,31 +813,11 @@ Mat& function	(T (*f)(T))
 	**---------------------------------------------*/
 	void LUPdecomposition(Mat& U, Mat& L, Mat<int>& P) {
 		if (rows != cols)error();
-		int n = rows;
+		int n = rows, sign;
 		Mat A(*this);
 		P.zero(n);
-		for (int i = 0; i < n; i++) P[i] = i;
-		//[1]
-		for (int k = 0; k < n; k++) {
-			//[2] 选主元
-			T maxvalue = 0;
-			int kt;
-			for (int i = k; i < n; i++) {
-				if (fabs(A(i, k)) > maxvalue) { maxvalue = fabs(A(i, k)); kt = i; }
-			}
-			if (maxvalue == 0) error();				// singular matrix，秩 rank<n
-			//[3] 置换行
-			for (int i = 0; i < n; i++) {
-				T t = A(k, i); A(k, i) = A(kt, i); A(kt, i) = t;
-			}
-			int t = P[k]; P[k] = P[kt]; P[kt] = t;
-			//[4] LU分解: 高斯消元法
-			for (int i = k + 1; i < n; i++) {
-				A(i, k) /= A(k, k);					//aik存储消去该行第k位所需的乘数,即L
-				for (int j = k + 1; j < n; j++)
-					A(i, j) -= A(i, k) * A(k, j);	//初等行变换，消去该行第k位
-			}
-		}
+		//[1]-[4] 分块实现, 见文件末 [LU分解]
+		if (!MatLU<T>::lu(n, A.data, P.data, sign)) error();		// singular matrix，秩 rank<n
 		//[5] A中包含U,L，分离出来即可
 		U.zero(n, n); 
 		L.E(n);
@@ -730,26 +841,13 @@ Mat& function	(T (*f)(T))
 		else error();
 		return ans.eatMat(ansTmp);
 	}
-	/*----------------卷积 [ conv ]----------------*/
+	/*----------------卷积 [ conv ]----------------
+	*	ans(x, y) = Σ a(x·stride - padding + kx, y·stride - padding + ky) · b(kx, ky), 越界处为0
+	*	由 MatConv 按核选择算法 (可分离/im2col+GEMM/FFT), 见文件末 [卷积]
+	**---------------------------------------------*/
 	Mat& conv(Mat& a, Mat& b, int padding = 0, int stride = 1) {
-		Mat ansTmp(
-			(a.rows - b.rows + 2 * padding) / stride + 1, 
-			(a.cols - b.cols + 2 * padding) / stride + 1
-		);
-		// for each element of output
-		for (int y = 0; y < ansTmp.cols; y++) {
-			for (int x = 0; x < ansTmp.rows; x++) {
-				// for each element of b
-				for (int ky = 0; ky < b.cols; ky++) {
-					for (int kx = 0; kx < b.rows; kx++) {
-						// get the corresponding element of a
-						int xt = -padding + x * stride + kx, 
-							yt = -padding + y * stride + ky;
-						ansTmp(x, y) += (xt < 0 || xt >= a.rows || yt < 0 || yt >= a.cols) ? 0 : a(xt, yt) * b(kx, ky);
-					}
-				}
-			}
-		}
+		Mat ansTmp;
+		MatConv<T>::conv(a, b, padding, stride, ansTmp);
 		return eatMat(ansTmp);
 	}
 	/*----------------函数操作 [ function ]----------------*/
@@ -775,6 +873,41 @@ Mat& function	(T (*f)(T))
 		for (int i = 0; i <   size(); i++) data[i] = f(data[i], i);
 		return *this;
 	}
+	/*----------------并行映射/归约 [ map / reduce ]----------------
+	*	元素数不少于 PARALLEL_N 时由线程池分段执行, 否则串行.
+	*	map:    同 function/functionIndex, 但 f 会被多线程并发调用, 须无副作用 (如勿调用 rand).
+	*	reduce: op 须满足结合律; 按 REDUCE_BLOCK 固定分块, 块间两两合并, 结果与线程数无关.
+	*			返回 op(init, a0 op a1 op ...), init 取 op 的单位元或任一元素 (max/min).
+	**-----------------------------------------------------------*/
+	template<typename F>
+	Mat& map(Mat& x, F&& f) {
+		alloc(x.rows, x.cols);
+		T* d = data; const T* s = x.data;
+		Parallel::parallelFor(size(), PARALLEL_N, [d, s, &f](int st, int ed) {
+			for (int i = st; i < ed; i++) d[i] = f(s[i]);
+		});
+		return *this;
+	}
+	template<typename F> Mat& map(F&& f) { return map(*this, f); }
+	template<typename F>
+	Mat& mapIndex(Mat& x, F&& f) {
+		alloc(x.rows, x.cols);
+		T* d = data; const T* s = x.data;
+		Parallel::parallelFor(size(), PARALLEL_N, [d, s, &f](int st, int ed) {
+			for (int i = st; i < ed; i++) d[i] = f(s[i], i);
+		});
+		return *this;
+	}
+	template<typename F> Mat& mapIndex(F&& f) { return mapIndex(*this, f); }
+	template<typename F>
+	T reduce(T init, F&& op) const {
+		const T* a = data;
+		return Parallel::parallelReduce(size(), REDUCE_BLOCK, PARALLEL_N / REDUCE_BLOCK, init, [a, &op](int st, int ed) {
+			T ans = a[st];
+			for (int i = st + 1; i < ed; i++) ans = op(ans, a[i]);
+			return ans;
+		}, op);
+	}
 /******************************************************************************
 *                    特殊操作
 -------------------------------------------------------------------------------
@@ -782,6 +915,10 @@ Mat& getCol	(int _col, Mat& a)				//读/写一列 [getCol/setCol]
 Mat& setCol	(int _col, Mat& a)
 Mat& getRow	(int _row, Mat& a)				//读/写一行 [getRow/setRow]
 Mat& block	(int rowSt, int rowEd, int colSt, int colEd, Mat& ans)	//子矩阵 [block]
+MatView<T> view	()							//视图 (不复制, 可读写) [view/col/row/block]
+MatView<T> col	(int _col)
+MatView<T> row	(int _row)
+MatView<T> block(int rowSt, int rowEd, int colSt, int colEd)
 Mat& horizStack	(Mat& a, Mat& b)            //水平向拼接 [horizStack ]
 ******************************************************************************/
 	/*----------------读/写一列 [getCol/setCol]----------------*/
@@ -814,6 +951,15 @@ Mat& horizStack	(Mat& a, Mat& b)            //水平向拼接 [horizStack ]
 				ans(i - rowSt, j - colSt) = (*this)(i, j);
 		return ans;
 	}
+	/*----------------视图 [view/col/row/block]----------------
+	*	不复制数据, 经视图写入即写回本矩阵. 见文件末 [视图]
+	**---------------------------------------------------------*/
+	MatView<T> view() { return MatView<T>(data, rows, cols, cols, 1); }
+	MatView<T> col(int _col) { return MatView<T>(data + _col, rows, 1, cols, 1); }
+	MatView<T> row(int _row) { return MatView<T>(data + _row * cols, 1, cols, cols, 1); }
+	MatView<T> block(int rowSt, int rowEd, int colSt, int colEd) {
+		return MatView<T>(data + rowSt * cols + colSt, rowEd - rowSt + 1, colEd - colSt + 1, cols, 1);
+	}
 	/*----------------拼接 [rows/colsStack]----------------*/
 	Mat& rowsStack(Mat& a, Mat& b) {
 		if (a.cols != b.cols)error();
@@ -841,4 +987,1063 @@ Mat& horizStack	(Mat& a, Mat& b)            //水平向拼接 [horizStack ]
 		return ans.eatMat(ansTmp);
 	}
 };
-#endif
\ No newline at end of file
+/******************************************************************************
+*                    定长矩阵 Mat<T, R, C>  (R > 0)
+*	[目的]: 三维点、4x4变换矩阵等小矩阵直接存于栈上, 免去 alloc/malloc 堆分配.
+*	[特点]:
+		[1] 尺寸为编译期常量, 循环边界固定, 编译器可完全展开.
+		[2] 函数同名于动态 Mat<T> (set/add/sub/mul/dot/cross_/normalize...),
+			参数可为定长或动态矩阵, 热点处改换局部变量类型即可, 无需重写.
+		[3] 同动态 Mat<T> 可相互赋值, 动态矩阵 += -= 亦接受定长矩阵.
+		[4] 结果先存于局部, 再写回, 故参数为自身亦无影响.
+-------------------------------------------------------------------------------
+Mat<double, 3>		三维列向量		(别名 Vec3)
+Mat<double, 4, 4>	4x4 矩阵		(别名 Mat4)
+******************************************************************************/
+template<class T, int R, int C>
+class Mat
+{
+public:
+	/*---------------- 核心数据 ----------------*/
+	T data[R * C];
+	static const int rows = R, cols = C;
+	/*---------------- 构造函数 ----------------*/
+	Mat() { zero(); }
+	Mat(std::initializer_list<T> list) { zero(); *this = list; }
+	template<class E> Mat(const MatExpr<E>& e) { *this = e; }
+	/*---------------- 报错/Size ----------------*/
+	static void error() { exit(-1); }
+	static constexpr int size() { return R * C; }
+	/*---------------- 取元素 ----------------*/
+	T& operator[](int i)		{ return data[i]; }
+	T& operator()(int x)		{ return data[x]; }
+	T& operator()(int x, int y) { return data[x * C + y]; }
+	/*---------------- 基础矩阵 ----------------*/
+	Mat& zero()     { for (int i = 0; i < R * C; i++) data[i] = 0; return *this; }
+	Mat& fill(T a)  { for (int i = 0; i < R * C; i++) data[i] = a; return *this; }
+	Mat& E() {
+		static_assert(R == C, "Mat::E() needs a square matrix");
+		zero();
+		for (int i = 0; i < R; i++) data[i * C + i] = 1;
+		return *this;
+	}
+	/*---------------- 赋值 ----------------*/
+	Mat& operator=(std::initializer_list<T> list) {
+		int i = 0;
+		for (auto& item : list) { if (i >= R * C) break; data[i++] = item; }
+		return *this;
+	}
+	Mat& operator=(const Mat<T>& a) {
+		if (a.rows * a.cols != R * C) error();
+		for (int i = 0; i < R * C; i++) data[i] = a.data[i];
+		return *this;
+	}
+	template<class E>
+	Mat& operator=(const MatExpr<E>& e) {
+		const E& x = e.self();
+		if (x.rows != R || x.cols != C) error();
+		for (int i = 0; i < R * C; i++) data[i] = x[i];
+		return *this;
+	}
+	Mat& set(T x, T y) {
+		static_assert(R * C == 2, "Mat::set(x, y) needs size 2");
+		data[0] = x; data[1] = y;
+		return *this;
+	}
+	Mat& set(T x, T y, T z) {
+		static_assert(R * C == 3, "Mat::set(x, y, z) needs size 3");
+		data[0] = x; data[1] = y; data[2] = z;
+		return *this;
+	}
+	/*---------------- 转动态矩阵 ----------------*/
+	Mat<T>& toMat(Mat<T>& ans) const {
+		ans.alloc(R, C);
+		memcpy(ans.data, data, sizeof(T) * R * C);
+		return ans;
+	}
+	/*---------------- 视图 ----------------*/
+	MatView<T> view()        { return MatView<T>(data, R, C, C, 1); }
+	MatView<T> col(int _col) { return MatView<T>(data + _col, R, 1, C, 1); }
+	MatView<T> row(int _row) { return MatView<T>(data + _row * C, 1, C, C, 1); }
+	/*---------------- 加减 [ add + / sub - ] ----------------*/
+	template<class Ma> Mat& operator+=(Ma& a) { for (int i = 0; i < R * C; i++) data[i] += a[i]; return *this; }
+	template<class Ma> Mat& operator-=(Ma& a) { for (int i = 0; i < R * C; i++) data[i] -= a[i]; return *this; }
+	template<class E>  Mat& operator+=(const MatExpr<E>& e) { const E& x = e.self(); for (int i = 0; i < R * C; i++) data[i] += x[i]; return *this; }
+	template<class E>  Mat& operator-=(const MatExpr<E>& e) { const E& x = e.self(); for (int i = 0; i < R * C; i++) data[i] -= x[i]; return *this; }
+	template<class Ma, class Mb> Mat& add(Ma& a, Mb& b) { for (int i = 0; i < R * C; i++) data[i] = a[i] + b[i]; return *this; }
+	template<class Ma, class Mb> Mat& sub(Ma& a, Mb& b) { for (int i = 0; i < R * C; i++) data[i] = a[i] - b[i]; return *this; }
+	/*---------------- 数乘 [ mul × ] ----------------*/
+	Mat& operator*=(const double a) { for (int i = 0; i < R * C; i++) data[i] *= a; return *this; }
+	template<class Mb> Mat& mul(const double a, Mb& b) { for (int i = 0; i < R * C; i++) data[i] = a * b[i]; return *this; }
+	/*---------------- 乘法 [ mul × ] ----------------
+	*	定长 × 定长: 维度编译期检查, 全展开.
+	*	动态 × 定长: 如 变换矩阵 TransformMat × 点, 运行期检查维度.
+	**------------------------------------------------*/
+	template<int K>
+	Mat& mul(Mat<T, R, K>& a, Mat<T, K, C>& b) {
+		T ans[R * C];
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++) {
+				T t = 0;
+				for (int k = 0; k < K; k++) t += a.data[i * K + k] * b.data[k * C + j];
+				ans[i * C + j] = t;
+			}
+		memcpy(data, ans, sizeof(T) * R * C);
+		return *this;
+	}
+	template<int K>
+	Mat& mul(Mat<T>& a, Mat<T, K, C>& b) {
+		if (a.rows != R || a.cols != K) error();
+		T ans[R * C];
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++) {
+				T t = 0;
+				for (int k = 0; k < K; k++) t += a.data[i * K + k] * b.data[k * C + j];
+				ans[i * C + j] = t;
+			}
+		memcpy(data, ans, sizeof(T) * R * C);
+		return *this;
+	}
+	/*---------------- 元素乘 [ elementMul × ] ----------------*/
+	template<class Ma, class Mb> Mat& elementMul(Ma& a, Mb& b) { for (int i = 0; i < R * C; i++) data[i] = a[i] * b[i]; return *this; }
+	template<class Ma>           Mat& elementMul(Ma& a)        { for (int i = 0; i < R * C; i++) data[i] *= a[i];        return *this; }
+	/*---------------- 点乘 [ dot · ] ----------------*/
+	template<class Ma, class Mb>
+	static T dot(Ma& a, Mb& b) {
+		T ans = a[0] * b[0];
+		for (int i = 1; i < R * C; i++) ans += a[i] * b[i];
+		return ans;
+	}
+	template<class Ma>
+	T dot(Ma& a) {
+		T ans = data[0] * a[0];
+		for (int i = 1; i < R * C; i++) ans += data[i] * a[i];
+		return ans;
+	}
+	/*---------------- 叉乘 [ cross × ] (三维) ----------------*/
+	template<class Ma, class Mb>
+	Mat& cross_(Ma& a, Mb& b) {
+		static_assert(R * C == 3, "Mat::cross_ needs 3-D vectors");
+		T x = a[1] * b[2] - a[2] * b[1],
+		  y = a[2] * b[0] - a[0] * b[2],
+		  z = a[0] * b[1] - a[1] * b[0];
+		data[0] = x; data[1] = y; data[2] = z;
+		return *this;
+	}
+	template<class Ma, class Mb>
+	Mat& cross(Ma& a, Mb& b) { return cross_(a, b); }
+	/*---------------- 范数/归一化 [ norm / normalize ] ----------------*/
+	T norm() { return sqrt(dot(*this)); }
+	Mat& normalize() {
+		T t = norm();
+		if (t == 0) return *this;
+		for (int i = 0; i < R * C; i++) data[i] /= t;
+		return *this;
+	}
+	Mat& normalized() { return normalize(); }
+	/*---------------- 转置 [ transpose T ] ----------------*/
+	Mat<T, C, R>& transpose(Mat<T, C, R>& ans) {
+		T t[R * C];
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				t[j * R + i] = data[i * C + j];
+		memcpy(ans.data, t, sizeof(T) * R * C);
+		return ans;
+	}
+	/*---------------- 求和/最值 ----------------*/
+	T sum() { T ans = data[0]; for (int i = 1; i < R * C; i++) ans += data[i]; return ans; }
+	T max() { T ans = data[0]; for (int i = 1; i < R * C; i++) ans = ans >= data[i] ? ans : data[i]; return ans; }
+	T min() { T ans = data[0]; for (int i = 1; i < R * C; i++) ans = ans <= data[i] ? ans : data[i]; return ans; }
+};
+typedef Mat<double, 2>		Vec2;
+typedef Mat<double, 3>		Vec3;
+typedef Mat<double, 4>		Vec4;
+typedef Mat<double, 3, 3>	Mat3;
+typedef Mat<double, 4, 4>	Mat4;
+/******************************************************************************
+*                    矩阵乘法 GEMM [ C += A B ]
+*	[问题]: 朴素 i-j-k 三重循环, 最内层 b(k, j) 沿列访问, 每步跨越一整行, 缓存命中极差.
+*	[算法]: 分块 + 打包 + 寄存器分块 (GotoBLAS/BLIS 结构)
+		[1] jc: B, C 按列分为 NC 宽的块
+		[2] pc: A, B 按 k 分为 KC 深的块, 将 B 块打包为 NR 列宽的连续面板 (常驻 L3/L2)
+		[3] ic: A 按行分为 MC 高的块, 打包为 MR 行高的连续面板 (常驻 L2)  —— 大矩阵时多线程
+		[4] jr, ir: 微内核计算 MR x NR 的 C 子块, 累加器全在寄存器, A/B 面板顺序读取
+*	[微内核]: double 且编译器开启 AVX2 + FMA 时, 用 4x8 的 _mm256_fmadd_pd 内核;
+			  否则为标量内核 (固定边界, 可由编译器自动向量化).
+*	[小矩阵]: 3x3, 4x4 等变换矩阵, 打包开销不划算, 直接 i-k-j 循环.
+*	[约定]: A(M x K), B(K x N), C(M x N) 均行优先连续存储, C 需预先清零.
+******************************************************************************/
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+template<class T>
+struct MatGemm {
+	enum { MR = 4, NR = 8, MC = 96, KC = 256, NC = 2048 };
+	/*---------------- 打包 A: MR 行面板, 面板内按 k 连续 [k * MR + i] ----------------*/
+	static void packA(int mc, int kc, const T* A, int lda, T* Ap) {
+		for (int ir = 0; ir < mc; ir += MR, Ap += MR * kc)
+			for (int k = 0; k < kc; k++)
+				for (int i = 0; i < MR; i++)
+					Ap[k * MR + i] = ir + i < mc ? A[(ir + i) * lda + k] : 0;
+	}
+	/*---------------- 打包 B: NR 列面板, 面板内按 k 连续 [k * NR + j] ----------------*/
+	static void packB(int kc, int nc, const T* B, int ldb, T* Bp) {
+		for (int jr = 0; jr < nc; jr += NR, Bp += NR * kc)
+			for (int k = 0; k < kc; k++)
+				for (int j = 0; j < NR; j++)
+					Bp[k * NR + j] = jr + j < nc ? B[k * ldb + jr + j] : 0;
+	}
+	/*---------------- 微内核: C(MR x NR) += Ap Bp ----------------*/
+	static void kernel(int kc, const T* Ap, const T* Bp, T* C, int ldc) {
+		T c[MR * NR] = { 0 };
+		for (int k = 0; k < kc; k++, Ap += MR, Bp += NR)
+			for (int i = 0; i < MR; i++)
+				for (int j = 0; j < NR; j++)
+					c[i * NR + j] += Ap[i] * Bp[j];
+		for (int i = 0; i < MR; i++)
+			for (int j = 0; j < NR; j++)
+				C[i * ldc + j] += c[i * NR + j];
+	}
+	/*---------------- 边缘子块: 先算入临时块, 再写回有效部分 ----------------*/
+	static void kernelEdge(int mr, int nr, int kc, const T* Ap, const T* Bp, T* C, int ldc) {
+		T c[MR * NR] = { 0 };
+		kernel(kc, Ap, Bp, c, NR);
+		for (int i = 0; i < mr; i++)
+			for (int j = 0; j < nr; j++)
+				C[i * ldc + j] += c[i * NR + j];
+	}
+	/*---------------- 小矩阵: i-k-j ----------------*/
+	static void gemmSmall(int M, int N, int K, const T* A, const T* B, T* C) { gemmSmall(M, N, K, A, K, B, N, C, N); }
+	static void gemmSmall(int M, int N, int K, const T* A, int lda, const T* B, int ldb, T* C, int ldc) {
+		for (int i = 0; i < M; i++)
+			for (int k = 0; k < K; k++) {
+				T a = A[i * lda + k];
+				const T* __restrict b = B + k * ldb;
+				T* __restrict c = C + i * ldc;
+				for (int j = 0; j < N; j++) c[j] += a * b[j];
+			}
+	}
+	/*---------------- C += A B ----------------
+	*	lda, ldb, ldc: 行距, 可作用于大矩阵中的子块 (如 LU 分解的尾部更新)
+	**-----------------------------------------*/
+	static void gemm(int M, int N, int K, const T* A, const T* B, T* C) { gemm(M, N, K, A, K, B, N, C, N); }
+	static void gemm(int M, int N, int K, const T* A, int lda, const T* B, int ldb, T* C, int ldc) {
+		if ((long long)M * N * K <= 32 * 32 * 32) { gemmSmall(M, N, K, A, lda, B, ldb, C, ldc); return; }
+		T* Bp = (T*)malloc(sizeof(T) * KC * (NC + NR));
+		int icNum = (M + MC - 1) / MC;
+		bool isParallel = (long long)M * N * K >= 128 * 128 * 128;
+		for (int jc = 0; jc < N; jc += NC) {
+			int nc = N - jc < NC ? N - jc : NC;
+			for (int pc = 0; pc < K; pc += KC) {
+				int kc = K - pc < KC ? K - pc : KC;
+				packB(kc, nc, B + pc * ldb + jc, ldb, Bp);
+				Parallel::parallelFor(icNum, isParallel ? 1 : icNum, [&](int st, int ed) {
+					T* Ap = (T*)malloc(sizeof(T) * (MC + MR) * KC);
+					for (int ic = st * MC; ic < ed * MC && ic < M; ic += MC) {
+						int mc = M - ic < MC ? M - ic : MC;
+						packA(mc, kc, A + ic * lda + pc, lda, Ap);
+						for (int jr = 0; jr < nc; jr += NR) {
+							int nr = nc - jr < NR ? nc - jr : NR;
+							for (int ir = 0; ir < mc; ir += MR) {
+								int mr = mc - ir < MR ? mc - ir : MR;
+								T* c = C + (ic + ir) * ldc + jc + jr;
+								if (mr == MR && nr == NR) kernel(kc, Ap + ir * kc, Bp + jr * kc, c, ldc);
+								else kernelEdge(mr, nr, kc, Ap + ir * kc, Bp + jr * kc, c, ldc);
+							}
+						}
+					}
+					free(Ap);
+				});
+			}
+		}
+		free(Bp);
+	}
+};
+#if defined(__AVX2__) && defined(__FMA__)
+/*---------------- 微内核 double AVX2+FMA: 4 x 8, 8 个 ymm 累加器 ----------------*/
+template<>
+inline void MatGemm<double>::kernel(int kc, const double* Ap, const double* Bp, double* C, int ldc) {
+	__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(),
+			c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd(),
+			c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(),
+			c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+	for (int k = 0; k < kc; k++, Ap += 4, Bp += 8) {
+		__m256d b0 = _mm256_loadu_pd(Bp), 
+				b1 = _mm256_loadu_pd(Bp + 4), a;
+		a = _mm256_broadcast_sd(Ap + 0); c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+		a = _mm256_broadcast_sd(Ap + 1); c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+		a = _mm256_broadcast_sd(Ap + 2); c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+		a = _mm256_broadcast_sd(Ap + 3); c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+	}
+	double* c = C;
+	_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00)); _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01)); c += ldc;
+	_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c10)); _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c11)); c += ldc;
+	_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c20)); _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c21)); c += ldc;
+	_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c30)); _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c31));
+}
+#endif
+/******************************************************************************
+*                    卷积 [ conv ]
+*	[问题]: 直接四重循环, 每个输出元素 kr·kc 次乘加且逐元素判断越界.
+*	[算法]: 先将输入补零为 P, 去掉越界判断, 再按核选择:
+		[1] 可分离: 核秩为1 (b = u vᵀ, 如 Sobel, Gauss), 先行向 v 后列向 u 两次一维卷积,
+			每元素 kr + kc 次乘加.
+		[2] FFT: 核面积 >= FFT_AREA 且估计运算量少于直接计算时, P 与 b 补零至 2 的幂,
+			频域相乘 F(P)·conj(F(b)) 后逆变换, 与核大小无关.
+		[3] im2col + GEMM: 其余情况, 每行输出按 TILE 列分块展开为 (kr·kc) x TILE 的列矩阵,
+			与核 (1 x kr·kc) 相乘, 由 MatGemm 完成, 列矩阵常驻缓存.
+		三者最内层均为单位步长的乘加循环 (可由编译器向量化), 按输出行多线程.
+*	[注]: 整数类型只走 [3], 结果与直接计算一致.
+******************************************************************************/
+#include <complex>
+#include <vector>
+template<class T>
+struct MatConv {
+	enum { FFT_AREA = 121, TILE = 256, PARALLEL_WORK = 1 << 15 };
+	/*---------------- FFT 是否更快: 直接乘加数 vs 三次二维FFT的估计运算量 ----------------*/
+	static bool isFFT(Mat<T>& P, Mat<T>& b, Mat<T>& out) {
+		if (b.size() < FFT_AREA) return false;
+		double H = 1, W = 1;
+		while (H < P.rows) H *= 2;
+		while (W < P.cols) W *= 2;
+		return (double)out.size() * b.size() > 16 * H * W * log2(H * W);
+	}
+	/*---------------- 入口 ----------------*/
+	static void conv(Mat<T>& a, Mat<T>& b, int padding, int stride, Mat<T>& out) {
+		int kr = b.rows, kc = b.cols;
+		Mat<T> P(a.rows + 2 * padding, a.cols + 2 * padding);
+		for (int i = 0; i < a.rows; i++)
+			memcpy(&P(i + padding, padding), &a(i, 0), sizeof(T) * a.cols);
+		out.zero((P.rows - kr) / stride + 1, (P.cols - kc) / stride + 1);
+		Select<std::is_floating_point<T>::value>::run(P, b, stride, out);
+	}
+	/*---------------- 算法选择 ----------------*/
+	template<bool isFloat, int = 0> struct Select {
+		static void run(Mat<T>& P, Mat<T>& b, int stride, Mat<T>& out) { im2col(P, b, stride, out); }
+	};
+	template<int D> struct Select<true, D> {
+		static void run(Mat<T>& P, Mat<T>& b, int stride, Mat<T>& out) {
+			Mat<T> u, v;
+			if (rank1(b, u, v))            separable(P, u, v, stride, out);
+			else if (isFFT(P, b, out))     fft      (P, b,    stride, out);
+			else                           im2col   (P, b,    stride, out);
+		}
+	};
+	/*---------------- 每行工作量 work 时, 每线程至少分得的行数 ----------------*/
+	static int minRows(long long work) { return work >= PARALLEL_WORK ? 1 : (int)(PARALLEL_WORK / (work + 1)) + 1; }
+	/*---------------- 秩1分解 b = u vᵀ ----------------*/
+	static bool rank1(Mat<T>& b, Mat<T>& u, Mat<T>& v) {
+		int r0, c0, index;
+		T pivot = 0;
+		for (int i = 0; i < b.size(); i++) if (fabs(b[i]) > fabs(pivot)) { pivot = b[i]; index = i; }
+		if (pivot == 0) return false;
+		b.i2xy(index, r0, c0);
+		T eps = 1e-6 * pivot * pivot;
+		for (int i = 0; i < b.rows; i++)
+			for (int j = 0; j < b.cols; j++)
+				if (fabs(b(i, j) * pivot - b(i, c0) * b(r0, j)) > eps) return false;
+		u.alloc(b.rows); v.alloc(b.cols);
+		for (int i = 0; i < b.rows; i++) u[i] = b(i, c0);
+		for (int j = 0; j < b.cols; j++) v[j] = b(r0, j) / pivot;
+		return true;
+	}
+	/*---------------- [1] 可分离 ----------------*/
+	static void separable(Mat<T>& P, Mat<T>& u, Mat<T>& v, int stride, Mat<T>& out) {
+		int oc = out.cols;
+		Mat<T> tmp(P.rows, oc);
+		Parallel::parallelFor(P.rows, minRows((long long)oc * v.size()), [&](int st, int ed) {
+			for (int x = st; x < ed; x++) {
+				T* __restrict t = &tmp(x, 0);
+				for (int j = 0; j < v.size(); j++) {
+					const T* __restrict p = &P(x, j); T w = v[j];
+					if (stride == 1) for (int y = 0; y < oc; y++) t[y] += w * p[y];
+					else             for (int y = 0; y < oc; y++) t[y] += w * p[y * stride];
+				}
+			}
+		});
+		Parallel::parallelFor(out.rows, minRows((long long)oc * u.size()), [&](int st, int ed) {
+			for (int x = st; x < ed; x++) {
+				T* __restrict o = &out(x, 0);
+				for (int i = 0; i < u.size(); i++) {
+					const T* __restrict t = &tmp(x * stride + i, 0); T w = u[i];
+					for (int y = 0; y < oc; y++) o[y] += w * t[y];
+				}
+			}
+		});
+	}
+	/*---------------- [3] im2col + GEMM ----------------*/
+	static void im2col(Mat<T>& P, Mat<T>& b, int stride, Mat<T>& out) {
+		int kr = b.rows, kc = b.cols, K = kr * kc, oc = out.cols;
+		Parallel::parallelFor(out.rows, minRows((long long)oc * K), [&](int st, int ed) {
+			T* col = (T*)malloc(sizeof(T) * K * TILE);
+			for (int x = st; x < ed; x++) {
+				for (int y0 = 0; y0 < oc; y0 += TILE) {
+					int tn = oc - y0 < TILE ? oc - y0 : TILE;
+					for (int i = 0; i < kr; i++)
+						for (int j = 0; j < kc; j++) {
+							T* c = col + (i * kc + j) * tn;
+							const T* p = &P(x * stride + i, y0 * stride + j);
+							if (stride == 1) memcpy(c, p, sizeof(T) * tn);
+							else for (int t = 0; t < tn; t++) c[t] = p[t * stride];
+						}
+					MatGemm<T>::gemmSmall(1, tn, K, b.data, col, &out(x, y0));
+				}
+			}
+			free(col);
+		});
+	}
+	/*---------------- [2] FFT ----------------*/
+	typedef std::complex<T> Complex;
+	static void fft1D(Complex* x, int n, int step, bool isInv) {
+		for (int i = 1, j = 0; i < n; i++) {								//位逆序
+			int bit = n >> 1;
+			for (; j & bit; bit >>= 1) j ^= bit;
+			j ^= bit;
+			if (i < j) std::swap(x[i * step], x[j * step]);
+		}
+		std::vector<Complex> w(n / 2);
+		for (int len = 2; len <= n; len <<= 1) {							//蝶形
+			int half = len / 2;
+			for (int j = 0; j < half; j++) {								//旋转因子
+				double theta = (isInv ? 2 : -2) * 3.14159265358979323846 * j / len;
+				w[j] = Complex(cos(theta), sin(theta));
+			}
+			for (int i = 0; i < n; i += len) {
+				for (int j = 0; j < half; j++) {
+					Complex a = x[(i + j) * step], b = x[(i + j + half) * step];
+					Complex c(b.real() * w[j].real() - b.imag() * w[j].imag(),	//不用 operator*, 免去 inf/nan 检查
+							  b.real() * w[j].imag() + b.imag() * w[j].real());
+					x[(i + j) * step] = a + c;
+					x[(i + j + half) * step] = a - c;
+				}
+			}
+		}
+	}
+	static void fft2D(std::vector<Complex>& X, int H, int W, bool isInv) {
+		Parallel::parallelFor(H, minRows(W * 16), [&](int st, int ed) {
+			for (int i = st; i < ed; i++) fft1D(&X[i * W], W, 1, isInv);
+		});
+		Parallel::parallelFor(W, minRows(H * 16), [&](int st, int ed) {
+			std::vector<Complex> c(H);										//列拷贝为连续
+			for (int j = st; j < ed; j++) {
+				for (int i = 0; i < H; i++) c[i] = X[i * W + j];
+				fft1D(&c[0], H, 1, isInv);
+				for (int i = 0; i < H; i++) X[i * W + j] = c[i];
+			}
+		});
+	}
+	static void fft(Mat<T>& P, Mat<T>& b, int stride, Mat<T>& out) {
+		int H = 1, W = 1;
+		while (H < P.rows) H <<= 1;
+		while (W < P.cols) W <<= 1;
+		std::vector<Complex> FP(H * W), Fb(H * W);
+		for (int i = 0; i < P.rows; i++) for (int j = 0; j < P.cols; j++) FP[i * W + j] = P(i, j);
+		for (int i = 0; i < b.rows; i++) for (int j = 0; j < b.cols; j++) Fb[i * W + j] = b(i, j);
+		fft2D(FP, H, W, false);
+		fft2D(Fb, H, W, false);
+		for (int i = 0; i < H * W; i++)									//相关 = F(P)·conj(F(b))
+			FP[i] = Complex(FP[i].real() * Fb[i].real() + FP[i].imag() * Fb[i].imag(),
+							FP[i].imag() * Fb[i].real() - FP[i].real() * Fb[i].imag());
+		fft2D(FP, H, W, true);
+		T k = (T)1 / ((T)H * W);
+		for (int x = 0; x < out.rows; x++)
+			for (int y = 0; y < out.cols; y++)
+				out(x, y) = FP[x * stride * W + y * stride].real() * k;
+	}
+};
+/******************************************************************************
+*                    LU分解 [ PA = LU ]  /  Cholesky分解 [ A = L Lᵀ ]
+*	[问题]: 逐列消元每步扫过整个尾部矩阵, 访存量 O(n³) 且无法利用缓存; 行列式按余子式展开为 O(n!).
+*	[算法]: 分块右视 LU (LAPACK getrf 结构), 块宽 NB
+		for k0 = 0, NB, 2NB...
+			[1] 面板分解: 对列 [k0, k0+NB) 逐列选主元、整行置换、消元, 仅更新面板内列
+			[2] U12 = L11~¹ A12		单位下三角求解, 行方向乘加
+			[3] A22 -= L21 U12		尾部更新, 占 O(n³) 中绝大部分, 由 MatGemm 完成 (分块, SIMD, 多线程)
+		Cholesky 同理: [1] 左视分解面板列 [2] A22 -= L21 L21ᵀ (MatGemm)
+*	[求解]: 多右端项 B (n x m) 按行做前代/回代, 最内层为长 m 的行乘加; m 较大时按列分段多线程.
+*	[选择]: A 对称时先试 Cholesky (运算量约为 LU 一半, 无需选主元), 非正定则退回 LU.
+*	[约定]: A 为 n x n 行优先, 原地覆盖; piv[i]: 分解后第i行对应原矩阵的行.
+******************************************************************************/
+template<class T>
+struct MatLU {
+	enum { NB = 64 };
+	/*---------------- LU 分解: 成功返回 true, 奇异返回 false. sign: 置换的符号 ----------------*/
+	static bool lu(int n, T* A, int* piv, int& sign) {
+		for (int i = 0; i < n; i++) piv[i] = i;
+		sign = 1;
+		T* Lneg = (T*)malloc(sizeof(T) * n * NB);
+		bool ok = true;
+		for (int k0 = 0; k0 < n && ok; k0 += NB) {
+			int nb = n - k0 < NB ? n - k0 : NB, k1 = k0 + nb;
+			//[1] 面板分解
+			for (int k = k0; k < k1; k++) {
+				int kt = k;
+				T maxvalue = fabs(A[k * n + k]);
+				for (int i = k + 1; i < n; i++)
+					if (fabs(A[i * n + k]) > maxvalue) { maxvalue = fabs(A[i * n + k]); kt = i; }
+				if (maxvalue == 0) { ok = false; break; }
+				if (kt != k) {
+					for (int j = 0; j < n; j++) { T t = A[k * n + j]; A[k * n + j] = A[kt * n + j]; A[kt * n + j] = t; }
+					int t = piv[k]; piv[k] = piv[kt]; piv[kt] = t;
+					sign = -sign;
+				}
+				for (int i = k + 1; i < n; i++) {
+					T l = A[i * n + k] /= A[k * n + k];
+					T* __restrict ai = A + i * n;
+					const T* __restrict ak = A + k * n;
+					for (int j = k + 1; j < k1; j++) ai[j] -= l * ak[j];
+				}
+			}
+			if (!ok || k1 == n) break;
+			//[2] U12 = L11~¹ A12
+			for (int i = k0 + 1; i < k1; i++)
+				for (int k = k0; k < i; k++) {
+					T l = A[i * n + k];
+					T* __restrict ai = A + i * n;
+					const T* __restrict ak = A + k * n;
+					for (int j = k1; j < n; j++) ai[j] -= l * ak[j];
+				}
+			//[3] A22 -= L21 U12
+			int m = n - k1;
+			for (int i = 0; i < m; i++)
+				for (int k = 0; k < nb; k++) Lneg[i * nb + k] = -A[(k1 + i) * n + k0 + k];
+			MatGemm<T>::gemm(m, m, nb, Lneg, nb, A + k0 * n + k1, n, A + k1 * n + k1, n);
+		}
+		free(Lneg);
+		return ok;
+	}
+	/*---------------- Cholesky 分解: L 存于下三角. 非正定返回 false ----------------*/
+	static bool cholesky(int n, T* A) {
+		T* Lneg = (T*)malloc(sizeof(T) * n * NB), 
+		 * LT   = (T*)malloc(sizeof(T) * n * NB);
+		bool ok = true;
+		for (int k0 = 0; k0 < n && ok; k0 += NB) {
+			int nb = n - k0 < NB ? n - k0 : NB, k1 = k0 + nb;
+			//[1] 面板分解 (左视, 面板之前的列已由尾部更新计入)
+			for (int j = k0; j < k1 && ok; j++) {
+				T d = A[j * n + j];
+				for (int k = k0; k < j; k++) d -= A[j * n + k] * A[j * n + k];
+				if (!(d > 0)) { ok = false; break; }
+				d = sqrt(d); A[j * n + j] = d;
+				for (int i = j + 1; i < n; i++) {
+					T t = A[i * n + j];
+					for (int k = k0; k < j; k++) t -= A[i * n + k] * A[j * n + k];
+					A[i * n + j] = t / d;
+				}
+			}
+			if (!ok || k1 == n) break;
+			//[2] A22 -= L21 L21ᵀ
+			int m = n - k1;
+			for (int i = 0; i < m; i++)
+				for (int k = 0; k < nb; k++) {
+					Lneg[i * nb + k] = -A[(k1 + i) * n + k0 + k];
+					LT  [k * m  + i] =  A[(k1 + i) * n + k0 + k];
+				}
+			MatGemm<T>::gemm(m, m, nb, Lneg, nb, LT, m, A + k1 * n + k1, n);
+		}
+		free(Lneg); free(LT);
+		return ok;
+	}
+	/*---------------- 是否对称 ----------------*/
+	static bool isSymmetric(int n, const T* A) {
+		for (int i = 0; i < n; i++)
+			for (int j = i + 1; j < n; j++)
+				if (fabs(A[i * n + j] - A[j * n + i]) > 1e-12 * (fabs(A[i * n + j]) + fabs(A[j * n + i]))) return false;
+		return true;
+	}
+	/*---------------- 行列式 (A 被覆盖) ----------------*/
+	static T det(int n, T* A) {
+		T ans = 1;
+		if (isSymmetric(n, A)) {
+			std::vector<T> a(A, A + n * n);
+			if (cholesky(n, &a[0])) {
+				for (int i = 0; i < n; i++) ans *= a[i * n + i] * a[i * n + i];
+				return ans;
+			}
+		}
+		std::vector<int> piv(n);
+		int sign;
+		if (!lu(n, A, &piv[0], sign)) return 0;
+		for (int i = 0; i < n; i++) ans *= A[i * n + i];
+		return sign * ans;
+	}
+	/*---------------- 前代/回代: 按右端项列分段多线程 ----------------*/
+	template<class F>
+	static void forRhs(int n, int m, F&& f) {
+		Parallel::parallelFor(m, (long long)n * n * m >= (1 << 21) ? 64 : m, f);
+	}
+	static void luSolve(int n, const T* LU, const int* piv, int m, T* B) {
+		std::vector<T> Bp(B, B + n * m);
+		for (int i = 0; i < n; i++) memcpy(B + i * m, &Bp[piv[i] * m], sizeof(T) * m);	// P B
+		forRhs(n, m, [&](int st, int ed) {
+			for (int i = 0; i < n; i++)										// L Y = P B
+				for (int k = 0; k < i; k++) {
+					T l = LU[i * n + k];
+					T* __restrict bi = B + i * m; const T* __restrict bk = B + k * m;
+					for (int j = st; j < ed; j++) bi[j] -= l * bk[j];
+				}
+			for (int i = n - 1; i >= 0; i--) {								// U X = Y
+				T* __restrict bi = B + i * m;
+				for (int k = i + 1; k < n; k++) {
+					T u = LU[i * n + k]; const T* __restrict bk = B + k * m;
+					for (int j = st; j < ed; j++) bi[j] -= u * bk[j];
+				}
+				for (int j = st; j < ed; j++) bi[j] /= LU[i * n + i];
+			}
+		});
+	}
+	static void choleskySolve(int n, const T* L, int m, T* B) {
+		forRhs(n, m, [&](int st, int ed) {
+			for (int i = 0; i < n; i++) {									// L Y = B
+				T* __restrict bi = B + i * m;
+				for (int k = 0; k < i; k++) {
+					T l = L[i * n + k]; const T* __restrict bk = B + k * m;
+					for (int j = st; j < ed; j++) bi[j] -= l * bk[j];
+				}
+				for (int j = st; j < ed; j++) bi[j] /= L[i * n + i];
+			}
+			for (int i = n - 1; i >= 0; i--) {								// Lᵀ X = Y
+				T* __restrict bi = B + i * m;
+				for (int k = i + 1; k < n; k++) {
+					T l = L[k * n + i]; const T* __restrict bk = B + k * m;
+					for (int j = st; j < ed; j++) bi[j] -= l * bk[j];
+				}
+				for (int j = st; j < ed; j++) bi[j] /= L[i * n + i];
+			}
+		});
+	}
+	/*---------------- 解 A X = B (A 被覆盖, B 被 X 覆盖). 奇异返回 false ----------------*/
+	static bool solve(int n, T* A, int m, T* B) {
+		if (isSymmetric(n, A)) {
+			std::vector<T> a(A, A + n * n);
+			if (cholesky(n, &a[0])) { choleskySolve(n, &a[0], m, B); return true; }
+		}
+		std::vector<int> piv(n);
+		int sign;
+		if (!lu(n, A, &piv[0], sign)) return false;
+		luSolve(n, A, &piv[0], m, B);
+		return true;
+	}
+};
+/******************************************************************************
+*                    对称特征分解 [ A = Q T Qᵀ = (Q Z) Λ (Q Z)ᵀ ]
+*	[问题]: 雅可比迭代每次旋转重算整矩阵乘法, 需多轮扫描, O(n³) x 轮数, 且三角函数开销大.
+*	[算法]:
+		[1] Householder 三对角化: 对 k = 0..n-3, 以反射 Hk = I - τ v vᵀ 消去第k列对角线下第2个以后的元素,
+			尾部更新 A22 -= v wᵀ + w vᵀ (秩2), 按行多线程. v 存于被消去位置.
+		[2] 三对角阵隐式QL (JAMA tql2), 特征值降序排列.
+			全部特征对: 旋转同时作用于 Zᵀ 的两行 (连续内存).
+			前 k 个   : QL 只求特征值 O(n²), 再对三对角阵逆迭代求 k 个特征向量, 相近特征值间正交化.
+		[3] 回代 X = Q Z: 每 NB 个反射合为 I - V Tb Vᵀ (紧凑WY), 由两次 MatGemm 完成.
+*	[复杂度]: [1] 4n³/3; 全部特征对 [2] O(n³); 前 k 个 [2] O(n² + nk²), [3] O(n²k).
+******************************************************************************/
+#include <limits>
+#include <algorithm>
+template<class T>
+struct MatEig {
+	enum { NB = 32 };
+	/*---------------- 入口: 前 k 个 (最大) 特征对 ----------------*/
+	static void eig(Mat<T>& In, Mat<T>& eigvec, Mat<T>& eigvalue, int k) {
+		int n = In.rows;
+		Mat<T> A(In);
+		std::vector<T> d(n), e(n), tau(n);
+		tridiagonalize(n, A.data, &d[0], &e[0], &tau[0]);
+		std::vector<int> idx(n);
+		Mat<T> Z(n, k);
+		if (k == n) {
+			Mat<T> Zt; Zt.E(n);											//行为特征向量
+			tql(n, &d[0], &e[0], Zt.data);
+			order(d, idx);
+			for (int c = 0; c < k; c++)
+				for (int i = 0; i < n; i++) Z(i, c) = Zt(idx[c], i);
+		}
+		else {
+			std::vector<T> dt(d), et(e);
+			tql(n, &d[0], &e[0], NULL);
+			order(d, idx);
+			inverseIteration(n, &dt[0], &et[0], d, idx, k, Z);
+		}
+		backTransform(n, A.data, &tau[0], Z);
+		eigvalue.zero(k, k);
+		for (int c = 0; c < k; c++) eigvalue(c, c) = d[idx[c]];
+		eigvec.eatMat(Z);
+	}
+	/*---------------- 特征值降序下标 ----------------*/
+	static void order(std::vector<T>& d, std::vector<int>& idx) {
+		for (int i = 0; i < idx.size(); i++) idx[i] = i;
+		std::sort(idx.begin(), idx.end(), [&](int a, int b) { return d[a] > d[b]; });
+	}
+	/*---------------- [1] Householder 三对角化: d 对角, e[i] = T(i+1, i) ----------------*/
+	static void tridiagonalize(int n, T* A, T* d, T* e, T* tau) {
+		std::vector<T> p(n), w(n);
+		for (int k = 0; k < n; k++) { tau[k] = 0; e[k] = 0; }
+		for (int k = 0; k + 2 < n; k++) {
+			//反射向量 v = [1, x1/(x0-β), ...], 使 Hk x = β e0
+			T* col = A + (k + 1) * n + k;
+			T sigma = 0;
+			for (int i = k + 2; i < n; i++) sigma += A[i * n + k] * A[i * n + k];
+			T x0 = *col;
+			if (sigma == 0) { e[k] = x0; *col = 1; continue; }			//已为三对角, τ = 0
+			T beta = -(x0 >= 0 ? 1 : -1) * sqrt(x0 * x0 + sigma), v0 = x0 - beta;
+			tau[k] = (beta - x0) / beta;
+			e[k] = beta; *col = 1;
+			for (int i = k + 2; i < n; i++) A[i * n + k] /= v0;
+			int m = n - k - 1, st = k + 1;
+			auto v = [&](int i) { return A[(st + i) * n + k]; };
+			//p = τ A22 v
+			Parallel::parallelFor(m, m >= 256 ? 32 : m, [&](int s, int t) {
+				for (int i = s; i < t; i++) {
+					const T* a = A + (st + i) * n + st;
+					T sum = 0;
+					for (int j = 0; j < m; j++) sum += a[j] * v(j);
+					p[i] = tau[k] * sum;
+				}
+			});
+			//w = p - τ/2 (pᵀv) v
+			T pv = 0;
+			for (int i = 0; i < m; i++) pv += p[i] * v(i);
+			for (int i = 0; i < m; i++) w[i] = p[i] - tau[k] / 2 * pv * v(i);
+			//A22 -= v wᵀ + w vᵀ
+			std::vector<T> vv(m);
+			for (int i = 0; i < m; i++) vv[i] = v(i);
+			Parallel::parallelFor(m, m >= 256 ? 32 : m, [&](int s, int t) {
+				for (int i = s; i < t; i++) {
+					T* __restrict a = A + (st + i) * n + st;
+					T vi = vv[i], wi = w[i];
+					for (int j = 0; j < m; j++) a[j] -= vi * w[j] + wi * vv[j];
+				}
+			});
+		}
+		for (int k = 0; k < n; k++) d[k] = A[k * n + k];
+		if (n >= 2) e[n - 2] = A[(n - 1) * n + n - 2];
+		e[n - 1] = 0;
+	}
+	/*---------------- [2] 隐式QL (JAMA tql2). Zt != NULL 时累积旋转至 Zt 的行 ----------------*/
+	static void tql(int n, T* d, T* e, T* Zt) {
+		T f = 0, tst1 = 0, eps = std::numeric_limits<T>::epsilon();
+		for (int l = 0; l < n; l++) {
+			tst1 = std::max(tst1, (T)(fabs(d[l]) + fabs(e[l])));
+			int m = l;
+			while (m < n - 1 && fabs(e[m]) > eps * tst1) m++;
+			if (m > l) {
+				do {
+					T g = d[l], p = (d[l + 1] - g) / (2 * e[l]), r = hypot(p, (T)1);
+					if (p < 0) r = -r;
+					d[l] = e[l] / (p + r);
+					d[l + 1] = e[l] * (p + r);
+					T dl1 = d[l + 1], h = g - d[l];
+					for (int i = l + 2; i < n; i++) d[i] -= h;
+					f += h;
+					p = d[m];
+					T c = 1, c2 = 1, c3 = 1, el1 = e[l + 1], s = 0, s2 = 0;
+					for (int i = m - 1; i >= l; i--) {
+						c3 = c2; c2 = c; s2 = s;
+						g = c * e[i]; h = c * p;
+						r = hypot(p, e[i]);
+						e[i + 1] = s * r;
+						s = e[i] / r; c = p / r;
+						p = c * d[i] - s * g;
+						d[i + 1] = h + s * (c * g + s * d[i]);
+						if (Zt != NULL) {
+							T* __restrict z0 = Zt + i * n;
+							T* __restrict z1 = Zt + (i + 1) * n;
+							for (int j = 0; j < n; j++) {
+								T t = z1[j];
+								z1[j] = s * z0[j] + c * t;
+								z0[j] = c * z0[j] - s * t;
+							}
+						}
+					}
+					p = -s * s2 * c3 * el1 * e[l] / dl1;
+					e[l] = s * p; d[l] = c * p;
+				} while (fabs(e[l]) > eps * tst1);
+			}
+			d[l] += f; e[l] = 0;
+		}
+	}
+	/*---------------- [2] 三对角阵逆迭代: Z 的第c列为特征值 d[idx[c]] 的特征向量 ----------------*/
+	static void inverseIteration(int n, T* a, T* b, std::vector<T>& d, std::vector<int>& idx, int k, Mat<T>& Z) {
+		T norm = 0, eps = std::numeric_limits<T>::epsilon();
+		for (int i = 0; i < n; i++) norm = std::max(norm, (T)(fabs(a[i]) + fabs(b[i]) + (i > 0 ? fabs(b[i - 1]) : 0)));
+		if (norm == 0) norm = 1;
+		std::vector<T> u0(n), u1(n), u2(n), l(n), x(n);
+		std::vector<char> piv(n);
+		for (int c = 0; c < k; c++) {
+			T lambda = d[idx[c]];
+			//LU (选主元) of T - λI, U 为三条带
+			T p0 = a[0] - lambda, p1 = n > 1 ? b[0] : 0, p2 = 0;
+			for (int i = 0; i < n; i++) {
+				if (i == n - 1) { u0[i] = p0; u1[i] = p1; u2[i] = 0; piv[i] = 0; break; }
+				T q0 = b[i], q1 = a[i + 1] - lambda, q2 = i + 2 < n ? b[i + 1] : 0;
+				if (fabs(q0) > fabs(p0)) { std::swap(p0, q0); std::swap(p1, q1); std::swap(p2, q2); piv[i] = 1; }
+				else piv[i] = 0;
+				if (fabs(p0) < eps * norm) p0 = eps * norm;
+				u0[i] = p0; u1[i] = p1; u2[i] = p2;
+				l[i] = q0 / p0;
+				p0 = q1 - l[i] * p1; p1 = q2 - l[i] * p2; p2 = 0;
+			}
+			if (fabs(u0[n - 1]) < eps * norm) u0[n - 1] = eps * norm;
+			//迭代
+			for (int i = 0; i < n; i++) x[i] = 1 + 1e-3 * ((i * 7919) % 101);
+			for (int iter = 0; iter < 3; iter++) {
+				for (int i = 0; i + 1 < n; i++) {
+					if (piv[i]) std::swap(x[i], x[i + 1]);
+					x[i + 1] -= l[i] * x[i];
+				}
+				for (int i = n - 1; i >= 0; i--) {
+					T t = x[i];
+					if (i + 1 < n) t -= u1[i] * x[i + 1];
+					if (i + 2 < n) t -= u2[i] * x[i + 2];
+					x[i] = t / u0[i];
+				}
+				for (int j = 0; j < c; j++) {							//与相近特征值的向量正交化
+					if (fabs(d[idx[j]] - lambda) > 1e-3 * norm) continue;
+					T dot = 0;
+					for (int i = 0; i < n; i++) dot += x[i] * Z(i, j);
+					for (int i = 0; i < n; i++) x[i] -= dot * Z(i, j);
+				}
+				T s = 0;
+				for (int i = 0; i < n; i++) s += x[i] * x[i];
+				s = 1 / sqrt(s);
+				for (int i = 0; i < n; i++) x[i] *= s;
+			}
+			for (int i = 0; i < n; i++) Z(i, c) = x[i];
+		}
+	}
+	/*---------------- [3] 回代 Z = H0 H1 ... Hn-3 Z, 紧凑WY分块 ----------------*/
+	static void backTransform(int n, T* A, T* tau, Mat<T>& Z) {
+		int k = Z.cols, rNum = n - 2;									//反射个数
+		if (rNum <= 0) return;
+		T* VT = (T*)malloc(sizeof(T) * NB * n),
+		 * Vn = (T*)malloc(sizeof(T) * NB * n),
+		 * Tb = (T*)malloc(sizeof(T) * NB * NB),
+		 * W  = (T*)malloc(sizeof(T) * NB * k),
+		 * W2 = (T*)malloc(sizeof(T) * NB * k);
+		for (int j0 = (rNum - 1) / NB * NB; j0 >= 0; j0 -= NB) {
+			int nb = rNum - j0 < NB ? rNum - j0 : NB, r0 = j0 + 1;		//反射 j 作用于行 [j+1, n)
+			int m = n - r0;
+			//V (m x nb): 第c列为 v_{j0+c}, 自第 c 行起
+			memset(VT, 0, sizeof(T) * nb * m);
+			for (int c = 0; c < nb; c++) {
+				int j = j0 + c;
+				for (int i = j + 1; i < n; i++) VT[c * m + (i - r0)] = A[i * n + j];
+			}
+			for (int i = 0; i < m; i++)
+				for (int c = 0; c < nb; c++) Vn[i * nb + c] = -VT[c * m + i];
+			//Tb: H_j0 ... H_j0+nb-1 = I - V Tb Vᵀ (上三角)
+			for (int c = 0; c < nb; c++) {
+				T t = tau[j0 + c];
+				for (int r = 0; r < c; r++) {
+					T s = 0;
+					for (int i = 0; i < m; i++) s += VT[r * m + i] * VT[c * m + i];
+					W[r] = s;
+				}
+				for (int r = 0; r < c; r++) {
+					T s = 0;
+					for (int q = r; q < c; q++) s += Tb[r * NB + q] * W[q];
+					Tb[r * NB + c] = -t * s;
+				}
+				for (int r = c + 1; r < nb; r++) Tb[r * NB + c] = 0;
+				Tb[c * NB + c] = t;
+			}
+			//W = Vᵀ Z, W2 = Tb W, Z -= V W2
+			memset(W, 0, sizeof(T) * nb * k);
+			memset(W2, 0, sizeof(T) * nb * k);
+			MatGemm<T>::gemm(nb, k, m, VT, m, Z.data + r0 * k, k, W, k);
+			for (int r = 0; r < nb; r++)
+				for (int q = r; q < nb; q++) {
+					T t = Tb[r * NB + q];
+					for (int j = 0; j < k; j++) W2[r * k + j] += t * W[q * k + j];
+				}
+			MatGemm<T>::gemm(m, k, nb, Vn, nb, W2, k, Z.data + r0 * k, k);
+		}
+		free(VT); free(Vn); free(Tb); free(W); free(W2);
+	}
+};
+/******************************************************************************
+*                    表达式模板 [ a + b * 2.0 - c ]
+*	[目的]: add/sub/mul 链式调用, 每步都生成完整的中间矩阵, 多次分配、多次遍历内存.
+			表达式模板将运算符组合为惰性的表达式树, 赋值时才逐元素一次循环求值.
+*	[原理]:
+		a + b * 2.0 - c   =>   Sub< Add< a, Scalar<b, 2.0> >, c >
+		Mat = 表达式      =>   for i: data[i] = (a[i] + b[i] * 2.0) - c[i]
+*	[运算]: 矩阵 ± 矩阵, 矩阵 * / 数, 数 * 矩阵, -矩阵, elementMul/elementDiv(a, b)
+			矩阵 * 矩阵 (矩阵乘法) 非逐元素, 不在此列, 仍用 mul().
+*	[别名]: 逐元素运算第i元只依赖各操作数第i元, 故 a = a + b 等自身参与运算亦结果正确.
+*	[注意]: 叶节点引用原矩阵数据, 表达式不可存留至原矩阵改变尺寸或析构之后.
+******************************************************************************/
+template<class E>
+struct MatExpr {
+	const E& self() const { return static_cast<const E&>(*this); }
+};
+/*---------------- 叶节点: 矩阵数据 ----------------*/
+template<class T>
+struct MatExprLeaf : public MatExpr<MatExprLeaf<T>> {
+	typedef T value_type;
+	const T* p; int rows, cols;
+	MatExprLeaf(const T* _p, int _rows, int _cols) : p(_p), rows(_rows), cols(_cols) { ; }
+	T operator[](int i) const { return p[i]; }
+};
+/*---------------- 逐元素运算 ----------------*/
+struct MatOpAdd { template<class T> static T apply(T a, T b) { return a + b; } };
+struct MatOpSub { template<class T> static T apply(T a, T b) { return a - b; } };
+struct MatOpMul { template<class T> static T apply(T a, T b) { return a * b; } };
+struct MatOpDiv { template<class T> static T apply(T a, T b) { return a / b; } };
+/*---------------- 二元节点: 矩阵 op 矩阵 ----------------*/
+template<class A, class B, class Op>
+struct MatExprBinary : public MatExpr<MatExprBinary<A, B, Op>> {
+	typedef typename A::value_type value_type;
+	A a; B b; int rows, cols;
+	MatExprBinary(const A& _a, const B& _b) : a(_a), b(_b), rows(_a.rows), cols(_a.cols) {
+		if (_a.rows != _b.rows || _a.cols != _b.cols) Mat<value_type>::error();
+	}
+	value_type operator[](int i) const { return Op::template apply<value_type>(a[i], b[i]); }
+};
+/*---------------- 数乘节点: 矩阵 op 数 ----------------*/
+template<class A, class Op>
+struct MatExprScalar : public MatExpr<MatExprScalar<A, Op>> {
+	typedef typename A::value_type value_type;
+	A a; double s; int rows, cols;									//数以double存储, 仅结果转回value_type (Mat<int> * 0.5 不截断为0)
+	MatExprScalar(const A& _a, double _s) : a(_a), s(_s), rows(_a.rows), cols(_a.cols) { ; }
+	value_type operator[](int i) const { return (value_type)Op::template apply<double>(a[i], s); }
+};
+/*---------------- 取负节点 ----------------*/
+template<class A>
+struct MatExprNeg : public MatExpr<MatExprNeg<A>> {
+	typedef typename A::value_type value_type;
+	A a; int rows, cols;
+	MatExprNeg(const A& _a) : a(_a), rows(_a.rows), cols(_a.cols) { ; }
+	value_type operator[](int i) const { return -a[i]; }
+};
+/*---------------- 操作数萃取: 矩阵 -> 叶节点, 表达式 (含视图) -> 自身 ----------------*/
+template<class X, class Enable = void>
+struct MatOperand { static const bool value = false; };
+template<class T, int R, int C>
+struct MatOperand<Mat<T, R, C>> {
+	static const bool value = true;
+	typedef MatExprLeaf<T> type;
+	static type get(const Mat<T, R, C>& x) { return type(x.data, x.rows, x.cols); }
+};
+template<class X>
+struct MatOperand<X, typename std::enable_if<std::is_base_of<MatExpr<X>, X>::value>::type> {
+	static const bool value = true;
+	typedef X type;
+	static const X& get(const X& x) { return x; }
+};
+#define MAT_EXPR_BINARY(OP, NAME)																\
+template<class A, class B>																		\
+typename std::enable_if<MatOperand<A>::value && MatOperand<B>::value,							\
+	MatExprBinary<typename MatOperand<A>::type, typename MatOperand<B>::type, NAME>>::type		\
+OP(const A& a, const B& b) {																	\
+	return MatExprBinary<typename MatOperand<A>::type, typename MatOperand<B>::type, NAME>(	\
+		MatOperand<A>::get(a), MatOperand<B>::get(b));											\
+}
+MAT_EXPR_BINARY(operator+,  MatOpAdd)
+MAT_EXPR_BINARY(operator-,  MatOpSub)
+MAT_EXPR_BINARY(elementMul, MatOpMul)
+MAT_EXPR_BINARY(elementDiv, MatOpDiv)
+#undef MAT_EXPR_BINARY
+template<class A>
+typename std::enable_if<MatOperand<A>::value, MatExprScalar<typename MatOperand<A>::type, MatOpMul>>::type
+operator*(const A& a, double s) { return MatExprScalar<typename MatOperand<A>::type, MatOpMul>(MatOperand<A>::get(a), s); }
+template<class A>
+typename std::enable_if<MatOperand<A>::value, MatExprScalar<typename MatOperand<A>::type, MatOpMul>>::type
+operator*(double s, const A& a) { return MatExprScalar<typename MatOperand<A>::type, MatOpMul>(MatOperand<A>::get(a), s); }
+template<class A>
+typename std::enable_if<MatOperand<A>::value, MatExprScalar<typename MatOperand<A>::type, MatOpDiv>>::type
+operator/(const A& a, double s) { return MatExprScalar<typename MatOperand<A>::type, MatOpDiv>(MatOperand<A>::get(a), s); }
+template<class A>
+typename std::enable_if<MatOperand<A>::value, MatExprNeg<typename MatOperand<A>::type>>::type
+operator-(const A& a) { return MatExprNeg<typename MatOperand<A>::type>(MatOperand<A>::get(a)); }
+/******************************************************************************
+*                    视图 [ MatView ]
+*	[目的]: getCol/getRow/block 每次复制数据到新矩阵. 视图只记录指针、尺寸、行距/列距,
+			由 Mat::view/col/row/block 得到, 零复制; 经视图写入即写回原矩阵.
+*	[定位]: 元素 (i, j) = data[i·rowStride + j·colStride]
+*	[读]: 可作表达式模板操作数 (Mat c = a.col(0) + b.col(1) * 2.0), 及 sum/dot/norm/max/min/transpose,
+			Mat::mul(视图, 视图).
+*	[写]: view = Mat / 视图 / 表达式 / 数, +=, -=. 视图之间 "=" 为复制元素, 不改变指向.
+*	[注意]: 视图引用原矩阵数据, 不可存留至原矩阵改变尺寸或析构之后;
+			写入时右端若读取同一矩阵的其他位置 (如 a.view() = a.view().transpose()), 结果未定义.
+******************************************************************************/
+template<class T>
+struct MatView : public MatExpr<MatView<T>> {
+	typedef T value_type;
+	T* data; int rows, cols, rowStride, colStride;
+	MatView(T* _data, int _rows, int _cols, int _rowStride, int _colStride) :
+		data(_data), rows(_rows), cols(_cols), rowStride(_rowStride), colStride(_colStride) { ; }
+	template<int R, int C>
+	MatView(Mat<T, R, C>& a) : data(a.data), rows(a.rows), cols(a.cols), rowStride(a.cols), colStride(1) { ; }
+	MatView(const MatView& a) = default;
+	/*---------------- 取元素 ----------------*/
+	inline int size() const { return rows * cols; }
+	inline T& operator()(int i, int j) const { return data[i * rowStride + j * colStride]; }
+	inline T& operator[](int i) const {								//按行优先序第i元
+		if (cols == 1) return data[i * rowStride];
+		if (rows == 1) return data[i * colStride];
+		return data[i / cols * rowStride + i % cols * colStride];
+	}
+	/*---------------- 子视图/转置 (零复制) ----------------*/
+	MatView col(int _col) const { return MatView(data + _col * colStride, rows, 1, rowStride, colStride); }
+	MatView row(int _row) const { return MatView(data + _row * rowStride, 1, cols, rowStride, colStride); }
+	MatView block(int rowSt, int rowEd, int colSt, int colEd) const {
+		return MatView(data + rowSt * rowStride + colSt * colStride, rowEd - rowSt + 1, colEd - colSt + 1, rowStride, colStride);
+	}
+	MatView transpose() const { return MatView(data, cols, rows, colStride, rowStride); }
+	/*---------------- 读 ----------------*/
+	T sum() const {
+		T ans = 0;
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) ans += (*this)(i, j);
+		return ans;
+	}
+	T dot(const MatView& b) const {
+		if (rows != b.rows || cols != b.cols) Mat<T>::error();
+		T ans = 0;
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) ans += (*this)(i, j) * b(i, j);
+		return ans;
+	}
+	T norm() const { return sqrt(dot(*this)); }
+	T max() const {
+		T ans = data[0];
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) ans = (*this)(i, j) > ans ? (*this)(i, j) : ans;
+		return ans;
+	}
+	T min() const {
+		T ans = data[0];
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) ans = (*this)(i, j) < ans ? (*this)(i, j) : ans;
+		return ans;
+	}
+	Mat<T>& toMat(Mat<T>& ans) const {
+		ans.alloc(rows, cols);
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) ans(i, j) = (*this)(i, j);
+		return ans;
+	}
+	/*---------------- 写回 ----------------*/
+	const MatView& fill(T x) const {
+		for (int i = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++) (*this)(i, j) = x;
+		return *this;
+	}
+	const MatView& operator=(T x) const { return fill(x); }
+	const MatView& operator=(const MatView& a) const { return assign(a, MatOpSet()); }
+	template<int R, int C> const MatView& operator= (const Mat<T, R, C>& a) const { return assign(MatView((T*)a.data, a.rows, a.cols, a.cols, 1), MatOpSet()); }
+	template<int R, int C> const MatView& operator+=(const Mat<T, R, C>& a) const { return assign(MatView((T*)a.data, a.rows, a.cols, a.cols, 1), MatOpAdd()); }
+	template<int R, int C> const MatView& operator-=(const Mat<T, R, C>& a) const { return assign(MatView((T*)a.data, a.rows, a.cols, a.cols, 1), MatOpSub()); }
+	template<class E> const MatView& operator= (const MatExpr<E>& e) const { return assign(e.self(), MatOpSet()); }
+	template<class E> const MatView& operator+=(const MatExpr<E>& e) const { return assign(e.self(), MatOpAdd()); }
+	template<class E> const MatView& operator-=(const MatExpr<E>& e) const { return assign(e.self(), MatOpSub()); }
+	struct MatOpSet { template<class U> static U apply(U, U b) { return b; } };
+	template<class E, class Op>
+	const MatView& assign(const E& e, Op) const {
+		if (rows != e.rows || cols != e.cols) Mat<T>::error();
+		for (int i = 0, k = 0; i < rows; i++)
+			for (int j = 0; j < cols; j++, k++) (*this)(i, j) = Op::template apply<T>((*this)(i, j), e[k]);
+		return *this;
+	}
+};
+#endif
@@ -0,0 +1,109 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MAT_ARENA_H
+#define MAT_ARENA_H
+#include <stdlib.h>
+#include <atomic>
+#include <vector>
+/******************************************************************************
+*                    Mat 临时内存池 [ MatArena ]
+*	[目的]: 求逆、伴随、Delaunay 等算法每次调用产生大量短命 Mat, 逐个 malloc/free 开销大.
+*	[用法]:
+		{
+			MatArena::Scope arenaScope;		//本线程此后的 Mat 分配均由内存池线性分配
+			Mat<> a(3, 3), b;				//...
+		}									//离开作用域, 池中内存整体 O(1) 回收
+*	[原理]:
+		[1] 每线程一个内存池 (thread_local), 由若干大块组成, 分配时仅移动块内偏移 (bump).
+		[2] 每次分配前置 ALIGN 字节的头, 记录所属块; 块带引用计数 = 1 (池本身) + 块内存活分配数.
+			Mat 释放时只将所属块计数减一, 不调用 free, 也不访问池对象 (可在别的线程、池销毁后释放).
+		[3] 最外层 Scope 进入/离开时回收: 计数为 1 (无存活分配) 的块偏移归零复用;
+			仍有 Mat 存活 (被移出作用域) 的块保留已用部分, 从其末尾继续分配, 不妨碍其余块复用.
+		[4] 池销毁 (线程退出) 时放弃各块的池引用, 无存活分配的块立即释放, 其余由最后一个 Mat 释放.
+*	[统计]: allocNum/allocBytes: 由池分配的次数/字节数, 即省去的 malloc 次数/字节数.
+*		escapeNum: 回收时仍有块被存活分配占用的次数.
+******************************************************************************/
+class MatArena {
+public:
+	struct Block {
+		char*  raw;													//malloc 所得
+		char*  data;												//对齐后起点
+		size_t size, used = 0;
+		std::atomic<long long> refs{ 1 };							//1 (池) + 存活分配数
+	};
+	static const size_t BLOCK_SIZE = 1 << 20, ALIGN = 32;			//ALIGN >= sizeof(Block*), 分配头
+	std::vector<Block*> blocks;
+	int    blockCur = 0;
+	int    depth  = 0;												//Scope 嵌套层数
+	long long allocNum = 0, allocBytes = 0,							//统计
+			  resetNum = 0, escapeNum  = 0;
+	size_t    usedBytes = 0, peakBytes = 0;
+	~MatArena() {
+		for (int i = 0; i < (int)blocks.size(); i++) unref(blocks[i]);
+	}
+	/*---------------- 本线程内存池 ----------------*/
+	static MatArena& local() { static thread_local MatArena arena; return arena; }
+	static MatArena* active() { MatArena& a = local(); return a.depth > 0 ? &a : NULL; }
+	/*---------------- 分配 ----------------*/
+	void* alloc(size_t n) {
+		n = (n + ALIGN - 1) & ~(ALIGN - 1);
+		size_t need = n + ALIGN;
+		int blockNum = blocks.size();
+		while (blockCur < blockNum && blocks[blockCur]->used + need > blocks[blockCur]->size) blockCur++;
+		if (blockCur == blockNum) {
+			Block* b = new Block;
+			b->size = need > BLOCK_SIZE ? need : BLOCK_SIZE;
+			b->raw  = (char*)malloc(b->size + ALIGN);
+			b->data = b->raw + (ALIGN - (size_t)b->raw % ALIGN) % ALIGN;
+			blocks.push_back(b);
+		}
+		Block* b = blocks[blockCur];
+		char* p = b->data + b->used;
+		*(Block**)p = b;
+		b->used += need; b->refs++;
+		usedBytes += need;
+		if (usedBytes > peakBytes) peakBytes = usedBytes;
+		allocNum++; allocBytes += n;
+		return p + ALIGN;
+	}
+	/*---------------- 释放 (仅计数) ----------------*/
+	static void release(void* p) { unref(*(Block**)((char*)p - ALIGN)); }
+	static void unref(Block* b) {
+		if (--b->refs == 0) { free(b->raw); delete b; }
+	}
+	/*---------------- 整体回收 ----------------*/
+	void reset() {
+		if (usedBytes != 0) resetNum++;
+		bool isEscape = false;
+		for (int i = 0; i < (int)blocks.size(); i++) {
+			if (blocks[i]->refs == 1) blocks[i]->used = 0;
+			else isEscape = true;
+		}
+		if (isEscape) escapeNum++;
+		blockCur = 0; usedBytes = 0;
+	}
+	/*---------------- 作用域 ----------------*/
+	class Scope {
+	public:
+		bool isOpen = true;
+		Scope() { MatArena& a = local(); if (a.depth++ == 0) a.reset(); }
+		~Scope() { end(); }
+		void end() {												//提前结束, 此后分配回到堆
+			if (!isOpen) return;
+			isOpen = false;
+			MatArena& a = local();
+			if (--a.depth == 0) a.reset();
+		}
+	};
+};
+#endif
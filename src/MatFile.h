@@ -0,0 +1,270 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MAT_FILE_H
+#define MAT_FILE_H
+#include <stdint.h>
+#include <limits.h>
+#include <vector>
+#include "Mat.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+namespace MatFile {
+/******************************************************************************
+*					.mat 二进制矩阵文件
+*	[目的]: Mat::set(fileName) 以 fscanf 逐个读文本, 大矩阵极慢.
+			二进制格式一次 fread/fwrite 完成, 亦可 mmap 直接映射为只读视图, 零复制.
+*	[格式]:
+		[1] 头 (64B)
+			[1.1] 标识		"LGMAT\0\0\1"	(8B)
+			[1.2] 类型		dtype			(4B)	0:其他 1:float 2:double 3:int 4:unsigned char 5:short
+			[1.3] 元素字节	elemSize		(4B)
+			[1.4] 行数		rows			(8B)
+			[1.5] 列数		cols			(8B)
+			[1.6] 数据偏移	dataOffset		(8B)	= 64, 数据起点按 64B 对齐
+			[1.7] 保留						(24B)
+		[2] 数据, 行优先, 小端
+-------------------------------------------------------------------------------
+bool write	(const char* fileName, Mat<T>& a);		//写 (一次写入)
+bool read	(const char* fileName, Mat<T>& a);		//读 (一次读入, dtype 不同时转换)
+Writer<T>									//流式写: 逐行块追加, 可超出内存
+Mapped<T>									//内存映射: 只读视图, 零复制
+******************************************************************************/
+struct Header {
+	char     magic[8];
+	uint32_t dtype, elemSize;
+	int64_t  rows, cols, dataOffset;
+	char     reserved[24];
+};
+static const char MAGIC[8] = { 'L', 'G', 'M', 'A', 'T', 0, 0, 1 };
+static const int  DATA_OFFSET = 64;
+/*---------------- 类型编码 ----------------*/
+template<class T> struct Dtype					{ enum { value = 0 }; };
+template<> struct Dtype<float>					{ enum { value = 1 }; };
+template<> struct Dtype<double>					{ enum { value = 2 }; };
+template<> struct Dtype<int>					{ enum { value = 3 }; };
+template<> struct Dtype<unsigned char>			{ enum { value = 4 }; };
+template<> struct Dtype<short>					{ enum { value = 5 }; };
+template<class T>
+static Header makeHeader(int64_t rows, int64_t cols) {
+	Header h;
+	memset(&h, 0, sizeof(Header));
+	memcpy(h.magic, MAGIC, 8);
+	h.dtype = Dtype<T>::value; h.elemSize = sizeof(T);
+	h.rows = rows; h.cols = cols; h.dataOffset = DATA_OFFSET;
+	return h;
+}
+static const uint32_t DTYPE_SIZE[] = { 0, sizeof(float), sizeof(double), sizeof(int), sizeof(unsigned char), sizeof(short) };
+/*---------------- 头校验 ----------------
+*	elemSize 须与 dtype 一致 (dtype 0 时只须非零); rows >= 0, 0 <= cols <= INT_MAX (视图列下标为 int);
+*	数据 [dataOffset, dataOffset + rows·cols·elemSize) 须在文件内 (按除法比较, 不溢出). fileSize: 文件字节数.
+*	rows·cols 可超过 int: read 读入 Mat 时另需 rows·cols <= INT_MAX (isFitMat), Mapped 可按行段取视图.
+**-----------------------------------------*/
+static bool checkHeader(const Header& h, int64_t fileSize) {
+	if (memcmp(h.magic, MAGIC, 8) != 0 || h.dtype > 5
+	|| (h.dtype == 0 ? h.elemSize == 0 : h.elemSize != DTYPE_SIZE[h.dtype])) return false;
+	if (h.rows < 0 || h.cols < 0 || h.cols > INT_MAX) return false;
+	if (h.dataOffset < (int64_t)sizeof(Header) || h.dataOffset > fileSize) return false;
+	return h.cols == 0 || h.rows <= (fileSize - h.dataOffset) / h.elemSize / h.cols;
+}
+static bool isFitMat(int64_t rows, int64_t cols) {						//可读入 Mat (元素数为 int)
+	return rows <= INT_MAX && (cols == 0 || rows <= INT_MAX / cols);
+}
+/*---------------- 64 位文件偏移 (Windows 下 long 为 32 位, ftell 超 2GB 即失败) ----------------*/
+static int seek64(FILE* fp, int64_t offset, int origin) {
+#ifdef _WIN32
+	return _fseeki64(fp, offset, origin);
+#else
+	return fseeko(fp, (off_t)offset, origin);
+#endif
+}
+static int64_t tell64(FILE* fp) {
+#ifdef _WIN32
+	return _ftelli64(fp);
+#else
+	return ftello(fp);
+#endif
+}
+/*---------------- 读入时类型转换 ----------------*/
+template<class T, class S>
+static void convert(const void* in, T* out, int64_t n) {
+	const S* s = (const S*)in;
+	for (int64_t i = 0; i < n; i++) out[i] = (T)s[i];
+}
+/*---------------- 写 ----------------*/
+template<class T>
+static bool write(const char* fileName, Mat<T>& a) {
+	FILE* fo = fopen(fileName, "wb");
+	if (fo == NULL) return false;
+	Header h = makeHeader<T>(a.rows, a.cols);
+	bool ok = fwrite(&h, sizeof(Header), 1, fo) == 1
+		   && fwrite(a.data, sizeof(T), a.size(), fo) == (size_t)a.size();
+	fclose(fo);
+	return ok;
+}
+/*---------------- 读 ----------------*/
+template<class T>
+static bool read(const char* fileName, Mat<T>& a) {
+	FILE* fi = fopen(fileName, "rb");
+	if (fi == NULL) return false;
+	Header h;
+	bool ok = seek64(fi, 0, SEEK_END) == 0;
+	int64_t fileSize = tell64(fi);
+	ok = ok && fileSize >= 0 && seek64(fi, 0, SEEK_SET) == 0
+		 && fread(&h, sizeof(Header), 1, fi) == 1 && checkHeader(h, fileSize) && isFitMat(h.rows, h.cols)
+		 && seek64(fi, h.dataOffset, SEEK_SET) == 0;
+	if (ok && h.dtype == Dtype<T>::value && h.elemSize == sizeof(T)) {
+		a.alloc((int)h.rows, (int)h.cols);
+		ok = fread(a.data, sizeof(T), a.size(), fi) == (size_t)a.size();
+	}
+	else if (ok) {
+		std::vector<char> buf(h.rows * h.cols * h.elemSize);
+		ok = buf.empty() || fread(&buf[0], h.elemSize, h.rows * h.cols, fi) == (size_t)(h.rows * h.cols);
+		a.alloc((int)h.rows, (int)h.cols);
+		switch (ok ? h.dtype : 0) {
+		case 1: convert<T, float>		 (buf.data(), a.data, a.size()); break;
+		case 2: convert<T, double>		 (buf.data(), a.data, a.size()); break;
+		case 3: convert<T, int>			 (buf.data(), a.data, a.size()); break;
+		case 4: convert<T, unsigned char>(buf.data(), a.data, a.size()); break;
+		case 5: convert<T, short>		 (buf.data(), a.data, a.size()); break;
+		default: ok = false;
+		}
+	}
+	fclose(fi);
+	return ok;
+}
+/******************************************************************************
+*					流式写 [ Writer ]
+*	[用法]: Writer<float> w; w.open("a.mat", cols); 循环 w.write(rowsData, n); w.close();
+*	[原理]: 先写占位头, 数据逐块追加, close 时回写总行数. 内存只需容纳一块.
+*	[上限]: cols <= INT_MAX, 总字节数不超过 int64 (Mapped 可读的范围); 超出时 write 失败.
+*		rows·cols > INT_MAX 的文件不能 read 进 Mat, 需用 Mapped 按行段取视图.
+*	[失败]: 任一次写入不完整后进入失败状态: 此后 write 均失败, close 不回写头并返回 false,
+*		文件头行数保持 0, 不会留下行错位的数据.
+******************************************************************************/
+template<class T>
+class Writer {
+public:
+	FILE* fo = NULL;
+	int64_t rows = 0, cols = 0;
+	bool isFailed = false;
+	~Writer() { close(); }
+	bool open(const char* fileName, int64_t _cols) {
+		close();
+		if (_cols < 0 || _cols > INT_MAX) return false;
+		fo = fopen(fileName, "wb");
+		if (fo == NULL) return false;
+		rows = 0; cols = _cols; isFailed = false;
+		Header h = makeHeader<T>(0, cols);
+		isFailed = fwrite(&h, sizeof(Header), 1, fo) != 1;
+		return !isFailed;
+	}
+	bool write(const T* data, int64_t rowNum) {					//追加 rowNum 行
+		if (fo == NULL || isFailed || rowNum < 0) return false;
+		if (cols != 0 && rows + rowNum > (INT64_MAX - DATA_OFFSET) / (int64_t)sizeof(T) / cols) return false;	//超出可读范围, 不写
+		if (fwrite(data, sizeof(T) * cols, rowNum, fo) != (size_t)rowNum) { isFailed = true; return false; }
+		rows += rowNum;
+		return true;
+	}
+	bool write(Mat<T>& a) {
+		if (a.cols != cols) Mat<T>::error();
+		return write(a.data, a.rows);
+	}
+	bool close() {
+		if (fo == NULL) return true;
+		bool ok = !isFailed;
+		if (ok) {
+			Header h = makeHeader<T>(rows, cols);
+			ok = seek64(fo, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(Header), 1, fo) == 1;
+		}
+		ok = fclose(fo) == 0 && ok;
+		fo = NULL;
+		return ok;
+	}
+};
+/******************************************************************************
+*					内存映射 [ Mapped ]
+*	[用法]: Mapped<double> m; m.open("a.mat"); MatView<double> v = m.view(); ...
+*	[原理]: 文件只读映射进地址空间, 由操作系统按页调入, 打开耗时与文件大小无关.
+*	[注意]: 映射为只读, 经视图写入会触发访问错误; 需修改时先 view().toMat() 复制.
+			dtype 须与 T 一致, 否则 open 失败.
+*	[大文件]: rows 为 int64, 元素数可超过 int; MatView 下标为 int, 故 view(rowSt, rowNum) 按行段取视图,
+			每段 rowNum·cols <= INT_MAX. view() 取全图, 仅适用于元素数不超过 int 的文件.
+******************************************************************************/
+template<class T>
+class Mapped {
+public:
+	const T* data = NULL;
+	int64_t rows = 0;
+	int     cols = 0;
+	void*  base = NULL;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE, mapping = NULL;
+#endif
+	~Mapped() { close(); }
+	bool open(const char* fileName) {
+		close();
+#ifdef _WIN32
+		file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER size;
+		GetFileSizeEx(file, &size);
+		length = (size_t)size.QuadPart;
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		base = mapping == NULL ? NULL : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		int fd = ::open(fileName, O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		fstat(fd, &st);
+		length = st.st_size;
+		base = length == 0 ? MAP_FAILED : mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (base == MAP_FAILED) base = NULL;
+#endif
+		if (base == NULL || length < sizeof(Header)) { close(); return false; }
+		const Header& h = *(const Header*)base;
+		if (!checkHeader(h, length) || h.dtype != Dtype<T>::value || h.elemSize != sizeof(T)) { close(); return false; }
+		rows = h.rows; cols = (int)h.cols;									//checkHeader 已保证 cols 不超过 int
+		data = (const T*)((const char*)base + h.dataOffset);
+		return true;
+	}
+	void close() {
+#ifdef _WIN32
+		if (base != NULL) UnmapViewOfFile(base);
+		if (mapping != NULL) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		mapping = NULL; file = INVALID_HANDLE_VALUE;
+#else
+		if (base != NULL) munmap(base, length);
+#endif
+		base = NULL; data = NULL; length = 0; rows = cols = 0;
+	}
+	MatView<T> view() const { return view(0, rows); }
+	MatView<T> view(int64_t rowSt, int64_t rowNum) const {				//第 [rowSt, rowSt + rowNum) 行
+		if (rowSt < 0 || rowNum < 0 || rowSt + rowNum > rows || !isFitMat(rowNum, cols)) Mat<T>::error();
+		return MatView<T>((T*)data + rowSt * cols, (int)rowNum, cols, cols, 1);
+	}
+	T operator()(int64_t i, int j) const { return data[i * cols + j]; }
+};
+}
+#endif
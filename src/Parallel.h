@@ -0,0 +1,133 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+namespace Parallel {
+/******************************************************************************
+*                    并行
+-------------------------------------------------------------------------------
+int  threadNum		();										//线程数
+void parallelFor	(int n, int minChunk, F&& f)			//并行 for: f(st, ed)
+V    parallelReduce	(int n, int block, int minBlocks, V init, F&& f, G&& combine)	//并行归约
+******************************************************************************/
+/*---------------- 线程数 ----------------
+*	可在编译时以 -DPARALLEL_THREAD_NUM=n 指定.
+**---------------------------------------*/
+inline int threadNum() {
+#ifdef PARALLEL_THREAD_NUM
+	static int n = PARALLEL_THREAD_NUM;
+#else
+	static int n = std::thread::hardware_concurrency();
+#endif
+	return n > 0 ? n : 1;
+}
+/******************************************************************************
+*                    线程池 [ ThreadPool ]
+*	[目的]: 每次 parallelFor 都创建/销毁线程, 开销约数十微秒, 小任务得不偿失.
+			常驻 threadNum()-1 个工作线程, 调用者线程也参与执行, 分派仅需一次唤醒.
+*	[规则]:
+		[1] 同一时刻只执行一批任务; 线程池忙 (其他线程正在使用) 或在任务内嵌套调用时, run 返回 false, 由调用者串行执行.
+		[2] 线程池有意不析构 (退出时工作线程阻塞于条件变量, 随进程结束), 避免 error()->exit 时回收线程死锁.
+******************************************************************************/
+class ThreadPool {
+public:
+	std::vector<std::thread> workers;
+	std::mutex mtx, runMtx;
+	std::condition_variable wakeCv, doneCv;
+	std::function<void(int)> task;
+	int taskNum = 0, taskNext = 0, taskDone = 0;
+	long long epoch = 0;
+	/*---------------- 全局线程池 ----------------*/
+	static ThreadPool& global() { static ThreadPool* p = new ThreadPool(threadNum() - 1); return *p; }
+	static bool& inTask() { static thread_local bool f = false; return f; }
+	ThreadPool(int n) {
+		for (int i = 0; i < n; i++) workers.push_back(std::thread([this]() { loop(); }));
+	}
+	/*---------------- 执行 f(0), f(1), ..., f(n-1) ----------------*/
+	template<class F>
+	bool run(int n, F& f) {
+		if (workers.empty() || inTask()) return false;
+		std::unique_lock<std::mutex> runLock(runMtx, std::try_to_lock);
+		if (!runLock.owns_lock()) return false;
+		std::unique_lock<std::mutex> lock(mtx);
+		task = [&f](int i) { f(i); };
+		taskNum = n; taskNext = 0; taskDone = 0; epoch++;
+		wakeCv.notify_all();
+		work(lock);
+		doneCv.wait(lock, [this]() { return taskDone == taskNum; });
+		task = nullptr;
+		return true;
+	}
+private:
+	void work(std::unique_lock<std::mutex>& lock) {				//领取并执行任务, 直至领完
+		inTask() = true;
+		while (taskNext < taskNum) {
+			int i = taskNext++;
+			lock.unlock(); task(i); lock.lock();
+			if (++taskDone == taskNum) doneCv.notify_all();
+		}
+		inTask() = false;
+	}
+	void loop() {
+		long long seen = 0;
+		std::unique_lock<std::mutex> lock(mtx);
+		while (true) {
+			wakeCv.wait(lock, [&]() { return epoch != seen; });
+			seen = epoch;
+			work(lock);
+		}
+	}
+};
+/*---------------- 并行 for ----------------
+*	[0, n) 均分为至多 threadNum() 段, 每段不少于 minChunk, 各段由线程池执行 f(st, ed).
+*	只有一段, 或线程池不可用时, 当前线程直接执行.
+**-----------------------------------------*/
+template<class F>
+void parallelFor(int n, int minChunk, F&& f) {
+	if (n <= 0) return;
+	int chunkNum = threadNum();
+	if (minChunk < 1) minChunk = 1;
+	if ((long long)chunkNum * minChunk > n) chunkNum = n / minChunk;
+	if (chunkNum <= 1) { f(0, n); return; }
+	auto chunk = [&f, n, chunkNum](int i) {
+		f((long long)n * i / chunkNum, (long long)n * (i + 1) / chunkNum);
+	};
+	if (!ThreadPool::global().run(chunkNum, chunk)) f(0, n);
+}
+/*---------------- 并行归约 ----------------
+*	[0, n) 按固定长度 block 分块, 块内由 f(st, ed) 求部分值, 块间按下标两两合并 (pairwise).
+*	分块与合并次序只取决于 n 与 block, 与线程数无关, 故结果确定, 可复现.
+*	块数少于 minBlocks 时不并行.
+**-----------------------------------------*/
+template<class V, class F, class G>
+V parallelReduce(int n, int block, int minBlocks, V init, F&& f, G&& combine) {
+	if (n <= 0) return init;
+	int blockNum = (n + block - 1) / block;
+	if (blockNum == 1) return combine(init, f(0, n));
+	std::vector<V> part(blockNum);
+	parallelFor(blockNum, minBlocks, [&](int st, int ed) {
+		for (int b = st; b < ed; b++)
+			part[b] = f(b * block, b == blockNum - 1 ? n : (b + 1) * block);
+	});
+	for (int step = 1; step < blockNum; step *= 2)
+		for (int b = 0; b + step < blockNum; b += 2 * step)
+			part[b] = combine(part[b], part[b + step]);
+	return combine(init, part[0]);
+}
+}
+#endif
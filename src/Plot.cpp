@@ -12,7 +12,7 @@ limitations under the License.
 ==============================================================================*/
 #include "Plot.h"
 /*--------------------------------[ init ]--------------------------------*/
-void Plot::init(Mat<>& x, Mat<>& y) {
+void Plot::init(Mat<real>& x, Mat<real>& y) {
 	static bool isinit = true;
 	if (isinit) {
 		isinit = false;
@@ -20,12 +20,12 @@ void Plot::init(Mat<>& x, Mat<>& y) {
 		pmax.alloc(2) = { x.max(),y.max() };
 		pdiff.sub(pmax, pmin);
 		p2v.elementDiv(pdiff, p2v.alloc(2) = { (double)g.Canvas.cols - 100,(double)g.Canvas.rows - 100 });
-		Mat<> tmp; (tmp.alloc(2) = { 100 / 2, 100 / 2 }).elementMul(p2v);
+		Mat<real> tmp; (tmp.alloc(2) = { 100 / 2, 100 / 2 }).elementMul(p2v);
 		setAxisLim(pmin -= tmp, pmax += tmp); pmin += tmp; pmax -= tmp;
 	}
 }
 /*--------------------------------[ plot ]--------------------------------*/
-void Plot::plot(Mat<>& x, Mat<>& y) {
+void Plot::plot(Mat<real>& x, Mat<real>& y) {
 	init(x, y);
 	for (int k = 0; k < y.cols; k++) 
 		for (int i = 0; i < y.rows - 1; i++) 
@@ -34,7 +34,7 @@ void Plot::plot(Mat<>& x, Mat<>& y) {
 				y[i], y[i + 1]
 			);
 }
-void Plot::plot(Mat<>& x, Mat<>& y, Mat<>& z) {
+void Plot::plot(Mat<real>& x, Mat<real>& y, Mat<real>& z) {
 	for (int i = 0; i < x.size() - 1; i++)
 		drawLine(
 			x[i], x[i + 1],
@@ -43,17 +43,17 @@ void Plot::plot(Mat<>& x, Mat<>& y, Mat<>& z) {
 		);
 }
 /*--------------------------------[ scatter ]--------------------------------*/
-void Plot::scatter(Mat<>& x, Mat<>& y) {
+void Plot::scatter(Mat<real>& x, Mat<real>& y) {
 	init(x, y);
 	for (int i = 0; i < x.size(); i++) drawPoint(x[i], y[i]);
 }
-void Plot::scatter(Mat<>& x, Mat<>& y, Mat<>& z) {
+void Plot::scatter(Mat<real>& x, Mat<real>& y, Mat<real>& z) {
 	init(x, y);
 	for (int i = 0; i < x.size(); i++) drawPoint(x[i], y[i], z[i]);
 }
 /*--------------------------------[ statirs ]--------------------------------*/
-void Plot::stairs(Mat<>& y) {
-	Mat<> ps(2), pe(2);
+void Plot::stairs(Mat<real>& y) {
+	Mat<real> ps(2), pe(2);
 	for (int k = 0; k < y.cols; k++) {
 		for (int i = 0; i < y.rows - 1; i++) {
 			ps = { (double)i,     y[i] };
@@ -64,9 +64,9 @@ void Plot::stairs(Mat<>& y) {
 		}
 	}
 }
-void Plot::stairs(Mat<>& x, Mat<>& y) {
+void Plot::stairs(Mat<real>& x, Mat<real>& y) {
 	init(x, y);
-	Mat<> ps(2), pe(2);
+	Mat<real> ps(2), pe(2);
 	for (int k = 0; k < y.cols; k++) {
 		for (int i = 0; i < y.rows - 1; i++) {
 			ps = { x[i],     y[i] };
@@ -78,8 +78,8 @@ void Plot::stairs(Mat<>& x, Mat<>& y) {
 	}
 }
 /*--------------------------------[ pie ]--------------------------------*/
-void Plot::pie(Mat<>& x, bool* explode) {
-	Mat<> zero(2);
+void Plot::pie(Mat<real>& x, bool* explode) {
+	Mat<real> zero(2);
 	double xsum = x.sum(), angle = 0;
 	for (int i = 0; i < x.size(); i++) {
 		if (explode != NULL && explode[i]) {
@@ -103,7 +103,7 @@ void Plot::pie(Mat<>& x, bool* explode) {
 //
 void Plot::axis() {
 	drawRectangle(pmin, pmax); 
-	Mat<> p(pmin.size()), ps(pmin.size()), pe(pmin.size()), diff;
+	Mat<real> p(pmin.size()), ps(pmin.size()), pe(pmin.size()), diff;
 	for (int dim = 0; dim < pmin.size(); dim++) {
 		ps.zero(); ps[dim] = pmin[dim]; 
 		pe.zero(); pe[dim] = pmax[dim];
@@ -125,7 +125,7 @@ void Plot::axis() {
 //
 void Plot::grid() {
 	g.PaintColor = 0xD0000000;
-	Mat<> ps, pe, diff;
+	Mat<real> ps, pe, diff;
 	diff.function(pdiff, [](double x) {
 		int ex = log10(x); return x / pow(10, ex) < 2 ? pow(10, ex - 1) : pow(10, ex);
 	});
@@ -140,6 +140,6 @@ void Plot::grid() {
 //
 void Plot::title(const char* words) 
 {
-	Mat<> p(2);
+	Mat<real> p(2);
 	drawString(p = { (pmin[0] + pmax[0]) / 2 - p2v[0] * strlen(words) * 5, pmax[1] + p2v[1] * 20 }, words);
 }
\ No newline at end of file
@@ -16,40 +16,40 @@ limitations under the License.
 //ѧͼ
 class Plot : public GraphicsND {
 public:
-	Mat<> pmin, pmax, pdiff, p2v;
+	Mat<real> pmin, pmax, pdiff, p2v;
 	Plot() { 
 		clear(0xFFFFFF); g.PaintColor = 0; FACE = 0; LINE = 1;
 	};
-	void init		(Mat<>& x, Mat<>& y);
+	void init		(Mat<real>& x, Mat<real>& y);
 	/*---------------- ͼ ----------------*/
-	void plot		(Mat<>& x, Mat<>& y);
-	void plot		(Mat<>& x, Mat<>& y, Mat<>& z);
-	void stairs		(Mat<>& y);
-	void stairs		(Mat<>& x, Mat<>& y);
-	void loglog		(Mat<>& x, Mat<>& y);
-	void semilogx	(Mat<>& x, Mat<>& y);
-	void semilogy	(Mat<>& x, Mat<>& y);
-	void polarplot	(Mat<>& x, Mat<>& y);
-	void polarscatter(Mat<>& x, Mat<>& y);
-	void contour3	(Mat<>& x);
+	void plot		(Mat<real>& x, Mat<real>& y);
+	void plot		(Mat<real>& x, Mat<real>& y, Mat<real>& z);
+	void stairs		(Mat<real>& y);
+	void stairs		(Mat<real>& x, Mat<real>& y);
+	void loglog		(Mat<real>& x, Mat<real>& y);
+	void semilogx	(Mat<real>& x, Mat<real>& y);
+	void semilogy	(Mat<real>& x, Mat<real>& y);
+	void polarplot	(Mat<real>& x, Mat<real>& y);
+	void polarscatter(Mat<real>& x, Mat<real>& y);
+	void contour3	(Mat<real>& x);
 	void image		(const char* fileName);
 	/*---------------- ͼ ----------------*/
-	void surf		(Mat<>& x, Mat<>& z);
-	void mesh		(Mat<>& x, Mat<>& z);
+	void surf		(Mat<real>& x, Mat<real>& z);
+	void mesh		(Mat<real>& x, Mat<real>& z);
 	/*---------------- άӻ ----------------*/
-	void coneplot	(Mat<>& x, Mat<>& z);
-	void quiver		(Mat<>& x, Mat<>& y);
-	void quiver		(Mat<>& x, Mat<>& y, Mat<>& z);
+	void coneplot	(Mat<real>& x, Mat<real>& z);
+	void quiver		(Mat<real>& x, Mat<real>& y);
+	void quiver		(Mat<real>& x, Mat<real>& y, Mat<real>& z);
 	/*---------------- ݷֲͼ ----------------*/
-	void histogram	(Mat<>& x);
-	void pie		(Mat<>& x, bool* explode = NULL);
-	void scatter	(Mat<>& x, Mat<>& y);
-	void scatter	(Mat<>& x, Mat<>& y, Mat<>& z);
-	void heatmap	(Mat<>& x);
+	void histogram	(Mat<real>& x);
+	void pie		(Mat<real>& x, bool* explode = NULL);
+	void scatter	(Mat<real>& x, Mat<real>& y);
+	void scatter	(Mat<real>& x, Mat<real>& y, Mat<real>& z);
+	void heatmap	(Mat<real>& x);
 	/*---------------- ɢͼ ----------------*/
-	void bar		(Mat<>& x);
-	void barh		(Mat<>& x);
-	void stem		(Mat<>& x);
+	void bar		(Mat<real>& x);
+	void barh		(Mat<real>& x);
+	void stem		(Mat<real>& x);
 	/*----------------  ----------------*/
 	void show();
 	/*----------------  ----------------*/
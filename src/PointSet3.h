@@ -0,0 +1,243 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef POINT_SET3_H
+#define POINT_SET3_H
+#include <vector>
+#include "Mat.h"
+/******************************************************************************
+*                    三维点集 (SoA) [ PointSet3 ]
+*	[目的]: 点以 Mat<> 数组存储 (AoS), 每点一次堆分配, 批量运算无法向量化.
+			PointSet3 将 x, y, z 分别连续存放 (32字节对齐), 批量运算的最内层为同构的单位步长循环,
+			编译器可直接生成 SIMD 指令; 点数较多时按段多线程.
+*	[转换]: fromMat/toMat: Mat<> 数组 (每个为3维列向量)、std::vector<Mat<>>、3 x N 矩阵 (每列一点)
+-------------------------------------------------------------------------------
+PointSet3(int n);										//构造
+void resize		(int n);								//点数
+void reserve	(int n);
+void push		(T x, T y, T z);						//追加一点
+PointSet3& fromMat	(Mat<T>* p, int n);					//转换 [fromMat/toMat]
+PointSet3& fromMat	(std::vector<Mat<T>>& p);
+PointSet3& fromMat	(Mat<T>& m);						//3 x N
+void toMat	(Mat<T>* p);
+void toMat	(std::vector<Mat<T>>& p);
+void toMat	(Mat<T>& m);
+PointSet3& transform	(Mat<T>& M);					//变换 3x3 / 4x4(仿射) [transform]
+PointSet3& translate	(T dx, T dy, T dz);				//平移/缩放
+PointSet3& scale		(T s);
+void dot		(PointSet3& b, T* out);					//逐点点乘 [dot]
+void dot		(T vx, T vy, T vz, T* out);
+PointSet3& cross	(PointSet3& a, PointSet3& b);		//逐点叉乘 [cross]
+void norm		(T* out);								//逐点范数/归一化 [norm/normalize]
+PointSet3& normalize();
+void aabb		(Mat<T, 3>& min, Mat<T, 3>& max);		//包围盒 [aabb]
+******************************************************************************/
+template<class T = double>
+class PointSet3 {
+public:
+	enum { ALIGN = 32, PARALLEL_N = 1 << 14 };
+	T* x = NULL, * y = NULL, * z = NULL;
+	int n = 0, capacity = 0;
+	void* raw = NULL;
+	/*---------------- 构造/析构 ----------------*/
+	PointSet3() { ; }
+	PointSet3(int _n) { resize(_n); }
+	PointSet3(const PointSet3& a) { *this = a; }
+	PointSet3(PointSet3&& a) noexcept { *this = std::move(a); }
+	~PointSet3() { free(raw); }
+	PointSet3& operator=(const PointSet3& a) {
+		if (&a == this) return *this;
+		resize(a.n);
+		memcpy(x, a.x, sizeof(T) * n);
+		memcpy(y, a.y, sizeof(T) * n);
+		memcpy(z, a.z, sizeof(T) * n);
+		return *this;
+	}
+	PointSet3& operator=(PointSet3&& a) noexcept {
+		if (&a == this) return *this;
+		free(raw);
+		raw = a.raw; x = a.x; y = a.y; z = a.z; n = a.n; capacity = a.capacity;
+		a.raw = NULL; a.x = a.y = a.z = NULL; a.n = a.capacity = 0;
+		return *this;
+	}
+	/*---------------- 分配: x, y, z 共用一块内存, 各自对齐至 ALIGN ----------------*/
+	void reserve(int _n) {
+		if (_n <= capacity) return;
+		int cap = (_n + ALIGN / sizeof(T) - 1) / (ALIGN / sizeof(T)) * (ALIGN / sizeof(T));
+		void* rawNew = malloc(sizeof(T) * cap * 3 + ALIGN);
+		T* xNew = (T*)(((size_t)rawNew + ALIGN - 1) / ALIGN * ALIGN);
+		if (n > 0) {
+			memcpy(xNew,           x, sizeof(T) * n);
+			memcpy(xNew + cap,     y, sizeof(T) * n);
+			memcpy(xNew + cap * 2, z, sizeof(T) * n);
+		}
+		free(raw);
+		raw = rawNew; x = xNew; y = xNew + cap; z = xNew + cap * 2;
+		capacity = cap;
+	}
+	void resize(int _n) { reserve(_n); n = _n; }
+	void clear() { n = 0; }
+	inline int size() const { return n; }
+	void push(T _x, T _y, T _z) {
+		if (n == capacity) reserve(capacity * 2 > 16 ? capacity * 2 : 16);
+		x[n] = _x; y[n] = _y; z[n] = _z; n++;
+	}
+	/*---------------- 分段执行 f(st, ed), 点数多时多线程 ----------------*/
+	template<class F> void forRange(F&& f) { Parallel::parallelFor(n, PARALLEL_N, f); }
+/******************************************************************************
+*                    转换
+******************************************************************************/
+	//源/目标标量类型 U 可与 T 不同 (如 Mat<> 几何数据转 float), 逐元素转换
+	template<class U>
+	PointSet3& fromMat(Mat<U>* p, int _n) {
+		resize(_n);
+		for (int i = 0; i < n; i++) { x[i] = (T)p[i][0]; y[i] = (T)p[i][1]; z[i] = (T)p[i][2]; }
+		return *this;
+	}
+	template<class U>
+	PointSet3& fromMat(std::vector<Mat<U>>& p) { return fromMat(p.data(), (int)p.size()); }
+	template<class U>
+	PointSet3& fromMat(Mat<U>& m) {								//3 x N, 每列一点
+		if (m.rows != 3) Mat<U>::error();
+		resize(m.cols);
+		const U* mx = &m(0, 0), * my = &m(1, 0), * mz = &m(2, 0);
+		for (int i = 0; i < n; i++) { x[i] = (T)mx[i]; y[i] = (T)my[i]; z[i] = (T)mz[i]; }
+		return *this;
+	}
+	template<class U>
+	void toMat(Mat<U>* p) {
+		for (int i = 0; i < n; i++) { p[i].alloc(3); p[i][0] = (U)x[i]; p[i][1] = (U)y[i]; p[i][2] = (U)z[i]; }
+	}
+	template<class U>
+	void toMat(std::vector<Mat<U>>& p) { p.resize(n); toMat(p.data()); }
+	template<class U>
+	void toMat(Mat<U>& m) {
+		m.alloc(3, n);
+		U* mx = &m(0, 0), * my = &m(1, 0), * mz = &m(2, 0);
+		for (int i = 0; i < n; i++) { mx[i] = (U)x[i]; my[i] = (U)y[i]; mz[i] = (U)z[i]; }
+	}
+/******************************************************************************
+*                    批量运算
+******************************************************************************/
+	/*---------------- 变换 [transform]: M 为 3x3 或 4x4 (仿射, 忽略末行) ----------------*/
+	PointSet3& transform(Mat<T>& M) {
+		if (M.cols != M.rows || (M.rows != 3 && M.rows != 4)) Mat<T>::error();
+		int c = M.cols;
+		T m[12] = { 0 };
+		for (int i = 0; i < 3; i++)
+			for (int j = 0; j < c; j++) m[i * 4 + j] = M(i, j);
+		forRange([&](int st, int ed) {
+			T* __restrict px = x, * __restrict py = y, * __restrict pz = z;
+			for (int i = st; i < ed; i++) {
+				T a = px[i], b = py[i], d = pz[i];
+				px[i] = m[0] * a + m[1] * b + m[ 2] * d + m[ 3];
+				py[i] = m[4] * a + m[5] * b + m[ 6] * d + m[ 7];
+				pz[i] = m[8] * a + m[9] * b + m[10] * d + m[11];
+			}
+		});
+		return *this;
+	}
+	template<int R, int C>
+	PointSet3& transform(Mat<T, R, C>& M) { Mat<T> t; return transform(M.toMat(t)); }
+	/*---------------- 平移/缩放 ----------------*/
+	PointSet3& translate(T dx, T dy, T dz) {
+		forRange([&](int st, int ed) {
+			for (int i = st; i < ed; i++) { x[i] += dx; y[i] += dy; z[i] += dz; }
+		});
+		return *this;
+	}
+	PointSet3& scale(T s) {
+		forRange([&](int st, int ed) {
+			for (int i = st; i < ed; i++) { x[i] *= s; y[i] *= s; z[i] *= s; }
+		});
+		return *this;
+	}
+	/*---------------- 逐点点乘 [dot] ----------------*/
+	void dot(PointSet3& b, T* out) {
+		if (b.n != n) Mat<T>::error();
+		forRange([&](int st, int ed) {
+			T* __restrict o = out;
+			for (int i = st; i < ed; i++) o[i] = x[i] * b.x[i] + y[i] * b.y[i] + z[i] * b.z[i];
+		});
+	}
+	void dot(T vx, T vy, T vz, T* out) {
+		forRange([&](int st, int ed) {
+			T* __restrict o = out;
+			for (int i = st; i < ed; i++) o[i] = x[i] * vx + y[i] * vy + z[i] * vz;
+		});
+	}
+	/*---------------- 逐点叉乘 [cross]: this = a × b (可为自身) ----------------*/
+	PointSet3& cross(PointSet3& a, PointSet3& b) {
+		if (a.n != b.n) Mat<T>::error();
+		resize(a.n);
+		forRange([&](int st, int ed) {
+			for (int i = st; i < ed; i++) {
+				T cx = a.y[i] * b.z[i] - a.z[i] * b.y[i],
+				  cy = a.z[i] * b.x[i] - a.x[i] * b.z[i],
+				  cz = a.x[i] * b.y[i] - a.y[i] * b.x[i];
+				x[i] = cx; y[i] = cy; z[i] = cz;
+			}
+		});
+		return *this;
+	}
+	/*---------------- 逐点范数/归一化 [norm/normalize] ----------------*/
+	void norm(T* out) {
+		forRange([&](int st, int ed) {
+			T* __restrict o = out;
+			for (int i = st; i < ed; i++) o[i] = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+		});
+	}
+	PointSet3& normalize() {
+		forRange([&](int st, int ed) {
+			for (int i = st; i < ed; i++) {
+				T t = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+				t = t == 0 ? 0 : 1 / t;
+				x[i] *= t; y[i] *= t; z[i] *= t;
+			}
+		});
+		return *this;
+	}
+	/*---------------- 包围盒 [aabb]: 各段分别归约, 再合并 ----------------*/
+	void aabb(Mat<T, 3>& min, Mat<T, 3>& max) {
+		if (n == 0) { min.zero(); max.zero(); return; }
+		int segNum = n / PARALLEL_N + 1;
+		std::vector<T> seg(segNum * 6);
+		for (int s = 0; s < segNum; s++) {
+			seg[s * 6 + 0] = seg[s * 6 + 3] = x[0];
+			seg[s * 6 + 1] = seg[s * 6 + 4] = y[0];
+			seg[s * 6 + 2] = seg[s * 6 + 5] = z[0];
+		}
+		Parallel::parallelFor(segNum, 1, [&](int sst, int sed) {
+			for (int s = sst; s < sed; s++) {
+				int st = (long long)n * s / segNum, ed = (long long)n * (s + 1) / segNum;
+				T* r = &seg[s * 6];
+				const T* p[3] = { x, y, z };
+				for (int k = 0; k < 3; k++) {
+					T mn = r[k], mx = r[k + 3];
+					for (int i = st; i < ed; i++) {
+						mn = p[k][i] < mn ? p[k][i] : mn;
+						mx = p[k][i] > mx ? p[k][i] : mx;
+					}
+					r[k] = mn; r[k + 3] = mx;
+				}
+			}
+		});
+		for (int k = 0; k < 3; k++) {
+			min[k] = seg[k]; max[k] = seg[k + 3];
+			for (int s = 1; s < segNum; s++) {
+				min[k] = seg[s * 6 + k]     < min[k] ? seg[s * 6 + k]     : min[k];
+				max[k] = seg[s * 6 + k + 3] > max[k] ? seg[s * 6 + k + 3] : max[k];
+			}
+		}
+	}
+};
+#endif
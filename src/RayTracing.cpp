@@ -34,7 +34,7 @@ limitations under the License.
 			Lf = L - F·2 cos<L,F>
 ******************************************************************************/
 Mat<>& reflect(Mat<>& RayI, Mat<>& faceVec, Mat<>& RayO) {
-	return RayO.add(RayO.mul(-2 * faceVec.dot(RayI), faceVec), RayI).normalize();
+	return (RayO = RayI + faceVec * (-2 * faceVec.dot(RayI))).normalize();
 }
 /******************************************************************************
 *						折射
@@ -51,7 +51,7 @@ Mat<>& refract(Mat<>& RayI, Mat<>& faceVec, Mat<>& RayO, double rateI, double ra
 		CosI = faceVec.dot(RayI),
 		CosO = 1 - pow(k, 2) * (1 - pow(CosI, 2));
 	return CosO < 0 ? reflect(RayI, faceVec, RayO) :				//全反射
-		RayO.add(RayI, RayO.mul(-CosI - (CosI > 0 ? -1 : 1)* sqrt(CosO) / k, faceVec)).normalize();
+		(RayO = RayI + faceVec * (-CosI - (CosI > 0 ? -1 : 1) * sqrt(CosO) / k)).normalize();
 }
 /******************************************************************************
 *						漫反射
@@ -60,13 +60,14 @@ Mat<>& refract(Mat<>& RayI, Mat<>& faceVec, Mat<>& RayO, double rateI, double ra
 ******************************************************************************/
 Mat<>& diffuseReflect(Mat<>& RayI, Mat<>& faceVec, Mat<>& RayO) {
 	double r1 = 2 * PI * RAND_DBL, r2 = RAND_DBL;
-	static Mat<> t(3), u, v;
+	Vec3 t, u, v;
 	faceVec *= faceVec.dot(RayI) > 0 ? -1 : 1;
 	t[0] = fabs(faceVec[0]) > 0.1 ? 0 : 1;
 	t[1] = t[0] == 0 ? 1 : 0;
 	u.mul(cos(r1) * sqrt(r2), u.cross_(t, faceVec).normalize());
 	v.mul(sin(r1) * sqrt(r2), v.cross_(faceVec, u).normalize());
-	return RayO.add(RayO.mul(sqrt(1 - r2), faceVec), u += v).normalize();
+	RayO.mul(sqrt(1 - r2), faceVec);
+	return (RayO += (u += v)).normalize();
 }
 
 /******************************************************************************
@@ -96,17 +97,17 @@ Mat<>& diffuseReflect(Mat<>& RayI, Mat<>& faceVec, Mat<>& RayO) {
 				v = (T×E1· D) / (D×E2·E1)
 ******************************************************************************/
 double RaySphere(Mat<>& RaySt, Mat<>& Ray, Mat<>& center, double& R) {
-	static Mat<> RayStCenter; RayStCenter.sub(RaySt, center);
+	Vec3 RayStCenter; RayStCenter.sub(RaySt, center);
 	double 
 		A = Ray.dot(Ray),
-		B = 2 * Ray.dot(RayStCenter),
+		B = 2 * RayStCenter.dot(Ray),
 		Delta = B * B - 4 * A * (RayStCenter.dot(RayStCenter) - R * R);
 	if (Delta < 0) return -DBL_MAX;									//有无交点
 	Delta = sqrt(Delta);
 	return (-B + (-B - Delta > 0 ? -Delta : Delta)) / (2 * A);
 }
 double RayTriangle(Mat<>& RaySt, Mat<>& Ray, Mat<>& p1, Mat<>& p2, Mat<>& p3) {
-	static Mat<> edge[2], tmp, p, q;
+	Vec3 edge[2], tmp, p, q;
 	edge[0].sub(p2, p1);
 	edge[1].sub(p3, p1);
 	// p & a & tmp
@@ -129,8 +130,7 @@ double RayTriangle(Mat<>& RaySt, Mat<>& Ray, Mat<>& p1, Mat<>& p2, Mat<>& p3) {
 /*--------------------------------[ 初始化 ]--------------------------------*/
 void RayTracing::init(int width, int height) {
 	ScreenPix.zero(height, width);
-	Screen.   zero(height, width);
-	for (int i = 0; i < Screen.size(); i++) Screen[i].zero(3);
+	Screen.   zero(height, width * 3);
 }
 /*--------------------------------[ 画像素 ]--------------------------------*/
 void RayTracing::setPix(int x, int y, Mat<>& color) {
@@ -158,18 +158,20 @@ void RayTracing::paint(const char* fileName, int sampleSt, int sampleEd) {
 	for (int sample = sampleSt; sample < sampleEd; sample++) {
 		if (sample % 1 == 0) { GraphicsFileCode::ppmWrite(fileName, ScreenPix); start = clock(); }
 		double rate = 1.0 / (sample + 1);
-		for (int x = 0; x < Screen.rows; x++) {
-			for (int y = 0; y < Screen.cols; y++) {
+		for (int x = 0; x < ScreenPix.rows; x++) {
+			for (int y = 0; y < ScreenPix.cols; y++) {
 				PixVec.add(														//[3]
-					PixXVec.mul(x + RAND_DBL - Screen.rows / 2 - 0.5, ScreenXVec),
-					PixYVec.mul(y + RAND_DBL - Screen.cols / 2 - 0.5, ScreenYVec)
+					PixXVec.mul(x + RAND_DBL - ScreenPix.rows / 2 - 0.5, ScreenXVec),
+					PixYVec.mul(y + RAND_DBL - ScreenPix.cols / 2 - 0.5, ScreenYVec)
 				);
 				traceRay(														//[4][5]
 					RaySt.add(gCenter,   PixVec), 
 					Ray.  add(ScreenVec, PixVec).normalize(), 
 					color.zero(), 0
 				);
-				setPix(x, y, (Screen(x, y) *= 1 - rate) += (color *= rate));
+				real* acc = &Screen(x, y * 3);									//累加以 double 计算, 存为 real
+				for (int k = 0; k < 3; k++) acc[k] = color[k] = acc[k] * (1 - rate) + color[k] * rate;
+				setPix(x, y, color);
 			} 
 		} if (sample % 1 == 0) printf("%d\ttime:%f sec\n", sample, (clock() - start) / double(CLK_TCK));
 	}
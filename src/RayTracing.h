@@ -19,6 +19,7 @@ limitations under the License.
 #include <algorithm>
 #include "RGB.h"
 #include "GraphicsFileCode.h"
+#include "GraphicsReal.h"
 #define PI 3.141592653589
 #define RAND_DBL (rand() / double(RAND_MAX))
 /*---------------- 几何光学 ----------------*/
@@ -31,6 +32,7 @@ double RayTriangle	(Mat<>& RaySt, Mat<>& Ray, Mat<>& p1, Mat<>& p2, Mat<>& p3);
 /*---------------- 光线追踪 ----------------*/
 class RayTracing {
 public:
+	typedef GRAPHICS_REAL real;
 	// 数据结构
 	struct Material {															//材质
 		Mat<> color{ 3 }, refractRate{ 3 };
@@ -46,7 +48,7 @@ public:
 	//基础参数 
 	Mat<> Eye{ 3 }, gCenter{ 3 };
 	Mat<RGB>	ScreenPix;
-	Mat<Mat<>>	Screen;
+	Mat<real>	Screen;														//累加缓冲: height x (width*3), 每像素 RGB 连续 (求交仍为 double)
 	int maxRayLevel = 5;
 	double ScreenXSize, ScreenYSize, eps = 1e-4;
 	std::vector<Triangle> TriangleSet;											//三角形集
@@ -0,0 +1,273 @@
+/*
+Copyright 2020,2021 LiGuer. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+	http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef SPARSE_MAT_H
+#define SPARSE_MAT_H
+#include <vector>
+#include <algorithm>
+#include "Mat.h"
+/******************************************************************************
+*                    稀疏矩阵 (CSR) [ SparseMat ]
+*	[目的]: 泊松图像编辑、网格平滑、图拉普拉斯等大型线性方程组, 矩阵几乎全为零.
+			稠密 solveEquations 为 O(n³) 时间、O(n²) 空间; 稀疏存储 + 迭代法每步仅 O(nnz).
+*	[存储]: CSR (压缩行)
+		rowPtr[i] ~ rowPtr[i+1]: 第 i 行非零元在 colIdx/val 中的区间, 行内按列号升序.
+*	[构造]: 由三元组 (COO) 构造, 同位置重复项相加 (便于有限元/拉普拉斯逐项累加).
+-------------------------------------------------------------------------------
+SparseMat(int rows, int cols);
+SparseMat& set	(int rows, int cols, std::vector<Triplet>& t);	//COO -> CSR [set]
+SparseMat& set	(int rows, int cols, int* I, int* J, T* V, int n);
+SparseMat& set	(Mat<T>& a, T eps = 0);							//稠密 -> 稀疏
+Mat<T>&	toMat	(Mat<T>& ans);									//稀疏 -> 稠密
+int	nnz			();												//非零元数
+T	operator()	(int i, int j);									//取元素
+Mat<T>&	mul		(Mat<T>& x, Mat<T>& ans);						//乘法 ans = A x [mul], x 可多列
+SparseMat& transpose(SparseMat& ans);							//转置 [transpose]
+Mat<T>&	diag	(Mat<T>& ans);									//对角元
+int	cg			(Mat<T>& b, Mat<T>& x, T eps, int maxIter);		//共轭梯度 [cg] (对称正定)
+int	bicgstab	(Mat<T>& b, Mat<T>& x, T eps, int maxIter);		//双共轭梯度稳定 [bicgstab] (一般方阵)
+******************************************************************************/
+template<class T = double>
+class SparseMat {
+public:
+	struct Triplet { int i, j; T v; };
+	enum { PARALLEL_N = 1 << 14 };									//行数不少于此值时并行
+	int rows = 0, cols = 0;
+	std::vector<int> rowPtr, colIdx;
+	std::vector<T>   val;
+	/*---------------- 构造 ----------------*/
+	SparseMat() { ; }
+	SparseMat(int _rows, int _cols) : rows(_rows), cols(_cols), rowPtr(_rows + 1, 0) { ; }
+	SparseMat(int _rows, int _cols, std::vector<Triplet>& t) { set(_rows, _cols, t); }
+	inline int nnz() const { return val.size(); }
+	/*---------------- COO -> CSR [set] ----------------
+	*	[过程]: 按行计数 -> 前缀和得 rowPtr -> 按行放置 -> 行内按列排序并合并重复项.
+	**------------------------------------------------*/
+	SparseMat& set(int _rows, int _cols, int* I, int* J, T* V, int n) {
+		rows = _rows; cols = _cols;
+		std::vector<int> cnt(rows + 1, 0), pos;
+		for (int k = 0; k < n; k++) {
+			if (I[k] < 0 || I[k] >= rows || J[k] < 0 || J[k] >= cols) Mat<T>::error();
+			cnt[I[k] + 1]++;
+		}
+		for (int i = 0; i < rows; i++) cnt[i + 1] += cnt[i];
+		pos = cnt;
+		std::vector<int> c(n); std::vector<T> v(n);
+		for (int k = 0; k < n; k++) { int p = pos[I[k]]++; c[p] = J[k]; v[p] = V[k]; }
+		rowPtr.assign(rows + 1, 0); colIdx.clear(); val.clear();
+		colIdx.reserve(n); val.reserve(n);
+		std::vector<int> order;
+		for (int i = 0; i < rows; i++) {
+			int orderNum = cnt[i + 1] - cnt[i];
+			order.resize(orderNum);
+			for (int k = 0; k < orderNum; k++) order[k] = cnt[i] + k;
+			std::sort(order.begin(), order.end(), [&c](int a, int b) { return c[a] < c[b]; });
+			for (int k = 0; k < orderNum; k++) {
+				if (k > 0 && c[order[k]] == colIdx.back()) val.back() += v[order[k]];
+				else { colIdx.push_back(c[order[k]]); val.push_back(v[order[k]]); }
+			}
+			rowPtr[i + 1] = val.size();
+		}
+		return *this;
+	}
+	SparseMat& set(int _rows, int _cols, std::vector<Triplet>& t) {
+		int n = t.size();
+		std::vector<int> I(n), J(n); std::vector<T> V(n);
+		for (int k = 0; k < n; k++) { I[k] = t[k].i; J[k] = t[k].j; V[k] = t[k].v; }
+		return set(_rows, _cols, I.data(), J.data(), V.data(), n);
+	}
+	/*---------------- 稠密 <-> 稀疏 ----------------*/
+	SparseMat& set(Mat<T>& a, T eps = 0) {
+		rows = a.rows; cols = a.cols;
+		rowPtr.assign(rows + 1, 0); colIdx.clear(); val.clear();
+		for (int i = 0; i < rows; i++) {
+			for (int j = 0; j < cols; j++)
+				if (a(i, j) > eps || a(i, j) < -eps) { colIdx.push_back(j); val.push_back(a(i, j)); }
+			rowPtr[i + 1] = val.size();
+		}
+		return *this;
+	}
+	Mat<T>& toMat(Mat<T>& ans) {
+		ans.zero(rows, cols);
+		for (int i = 0; i < rows; i++)
+			for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) ans(i, colIdx[k]) = val[k];
+		return ans;
+	}
+	/*---------------- 取元素 (行内二分) ----------------*/
+	T operator()(int i, int j) const {
+		const int* st = colIdx.data() + rowPtr[i], * ed = colIdx.data() + rowPtr[i + 1];
+		const int* p = std::lower_bound(st, ed, j);
+		return p != ed && *p == j ? val[p - colIdx.data()] : 0;
+	}
+	/*---------------- 对角元 ----------------*/
+	Mat<T>& diag(Mat<T>& ans) {
+		ans.zero(rows < cols ? rows : cols);
+		for (int i = 0; i < ans.rows; i++) ans[i] = (*this)(i, i);
+		return ans;
+	}
+	/*---------------- 乘法 [mul]: ans = A x, x 为 cols x k 稠密矩阵, 按行并行 ----------------*/
+	Mat<T>& mul(Mat<T>& x, Mat<T>& ans) {
+		if (x.rows != cols) Mat<T>::error();
+		Mat<T> ansTmp; ansTmp.alloc(rows, x.cols);
+		int k = x.cols;
+		const int* rp = rowPtr.data(), * ci = colIdx.data();
+		const T* v = val.data(), * xd = x.data;
+		T* y = ansTmp.data;
+		Parallel::parallelFor(rows, PARALLEL_N, [=](int st, int ed) {
+			for (int i = st; i < ed; i++) {
+				if (k == 1) {
+					T s = 0;
+					for (int p = rp[i]; p < rp[i + 1]; p++) s += v[p] * xd[ci[p]];
+					y[i] = s;
+					continue;
+				}
+				T* yi = y + (long long)i * k;
+				for (int j = 0; j < k; j++) yi[j] = 0;
+				for (int p = rp[i]; p < rp[i + 1]; p++) {
+					const T* xr = xd + (long long)ci[p] * k; T a = v[p];
+					for (int j = 0; j < k; j++) yi[j] += a * xr[j];
+				}
+			}
+		});
+		return ans.eatMat(ansTmp);
+	}
+	/*---------------- 转置 [transpose] ----------------*/
+	SparseMat& transpose(SparseMat& ans) {
+		SparseMat t(cols, rows);
+		t.colIdx.resize(nnz()); t.val.resize(nnz());
+		for (int k = 0; k < nnz(); k++) t.rowPtr[colIdx[k] + 1]++;
+		for (int j = 0; j < cols; j++) t.rowPtr[j + 1] += t.rowPtr[j];
+		std::vector<int> pos(t.rowPtr.begin(), t.rowPtr.end() - 1);
+		for (int i = 0; i < rows; i++)								//行序遍历, 转置后行内列号自然升序
+			for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+				int p = pos[colIdx[k]]++;
+				t.colIdx[p] = i; t.val[p] = val[k];
+			}
+		std::swap(ans.rows, t.rows); std::swap(ans.cols, t.cols);
+		ans.rowPtr.swap(t.rowPtr); ans.colIdx.swap(t.colIdx); ans.val.swap(t.val);
+		return ans;
+	}
+/******************************************************************************
+*                    迭代法解方程组 A x = b
+*	[预条件]: Jacobi (对角) 预条件 M = diag(A), 对角占优/拉普拉斯类矩阵收敛明显加快; 对角为零处取 1.
+*	[参数]: b 可为多列, 逐列求解; x 尺寸与 b 相同时作为初值, 否则从零开始.
+			eps: 相对残差 ||r|| / ||b|| 阈值; maxIter <= 0 时取 2 * rows.
+*	[返回]: 各列迭代次数的最大值; 未收敛时为 maxIter.
+******************************************************************************/
+	/*---------------- 共轭梯度 [cg] (对称正定) ----------------
+	*	[算法]:
+			r = b - A x, z = M⁻¹ r, p = z
+			循环: α = (r·z) / (p·Ap), x += α p, r -= α Ap
+				  z' = M⁻¹ r, β = (r'·z') / (r·z), p = z' + β p
+	**-------------------------------------------------------*/
+	int cg(Mat<T>& b, Mat<T>& x, T eps = 1e-10, int maxIter = 0) {
+		return solve(b, x, eps, maxIter, [this](Mat<T>& b, Mat<T>& x, Mat<T>& invD, T eps, int maxIter) {
+			Mat<T> r, z, p, Ap;
+			mul(x, Ap); r.sub(b, Ap);
+			z.elementMul(invD, r); p = z;
+			T rz = r.dot(z), bNorm = b.norm(), tol = eps * (bNorm == 0 ? 1 : bNorm);
+			int iter = 0;
+			for (; iter < maxIter && r.norm() > tol; iter++) {
+				mul(p, Ap);
+				T pAp = p.dot(Ap);
+				if (pAp == 0) break;
+				T alpha = rz / pAp;
+				axpy( alpha, p,  x);
+				axpy(-alpha, Ap, r);
+				z.elementMul(invD, r);
+				T rzNew = r.dot(z), beta = rzNew / rz;
+				rz = rzNew;
+				xpby(z, beta, p);
+			}
+			return iter;
+		});
+	}
+	/*---------------- 双共轭梯度稳定 [bicgstab] (一般方阵) ----------------
+	*	[算法]: 右预条件 BiCGSTAB
+			r = b - A x, r0 = r, ρ = α = ω = 1, v = p = 0
+			循环: ρ' = r0·r (ρ' ≈ 0 时令 r0 = r 重启), β = (ρ'/ρ)(α/ω), p = r + β (p - ω v)
+				  y = M⁻¹ p, v = A y, α = ρ' / (r0·v), s = r - α v
+				  z = M⁻¹ s, t = A z, ω = (t·s) / (t·t)
+				  x += α y + ω z, r = s - ω t
+	**-------------------------------------------------------*/
+	int bicgstab(Mat<T>& b, Mat<T>& x, T eps = 1e-10, int maxIter = 0) {
+		return solve(b, x, eps, maxIter, [this](Mat<T>& b, Mat<T>& x, Mat<T>& invD, T eps, int maxIter) {
+			int n = b.rows;
+			Mat<T> r, r0, p(n), v(n), y, s, z, t;
+			mul(x, v); r.sub(b, v); r0 = r; v.zero();
+			T rho = 1, alpha = 1, omega = 1, bNorm = b.norm(), tol = eps * (bNorm == 0 ? 1 : bNorm);
+			int iter = 0;
+			for (; iter < maxIter && r.norm() > tol; iter++) {
+				T rhoNew = r0.dot(r);
+				if (fabs(rhoNew) <= 1e-12 * r0.norm() * r.norm()) {		//r0 与 r 近乎正交 (Lanczos 中断): 以当前残差重启
+					r0 = r; p.zero(); v.zero();
+					rho = alpha = omega = 1;
+					rhoNew = r0.dot(r);
+				}
+				T beta = (rhoNew / rho) * (alpha / omega);
+				rho = rhoNew;
+				axpy(-omega, v, p);
+				xpby(r, beta, p);
+				y.elementMul(invD, p);
+				mul(y, v);
+				T r0v = r0.dot(v);
+				if (r0v == 0) break;
+				alpha = rho / r0v;
+				s = r; axpy(-alpha, v, s);
+				if (s.norm() <= tol) { axpy(alpha, y, x); r = s; iter++; break; }
+				z.elementMul(invD, s);
+				mul(z, t);
+				T tt = t.dot(t);
+				omega = tt == 0 ? 0 : t.dot(s) / tt;
+				axpy(alpha, y, x);
+				axpy(omega, z, x);
+				r = s; axpy(-omega, t, r);
+				if (omega == 0) break;
+			}
+			return iter;
+		});
+	}
+private:
+	/*---------------- 逐列求解公共部分 ----------------*/
+	template<class F>
+	int solve(Mat<T>& b, Mat<T>& x, T eps, int maxIter, F&& f) {
+		if (rows != cols || b.rows != rows) Mat<T>::error();
+		if (maxIter <= 0) maxIter = 2 * rows;
+		Mat<T> invD; diag(invD);
+		for (int i = 0; i < rows; i++) invD[i] = invD[i] == 0 ? 1 : 1 / invD[i];
+		if (x.rows != b.rows || x.cols != b.cols) x.zero(b.rows, b.cols);
+		if (b.cols == 1) return f(b, x, invD, eps, maxIter);
+		int iterMax = 0;
+		Mat<T> bj, xj;
+		for (int j = 0; j < b.cols; j++) {
+			b.getCol(j, bj); x.getCol(j, xj);
+			int iter = f(bj, xj, invD, eps, maxIter);
+			iterMax = iter > iterMax ? iter : iterMax;
+			x.setCol(j, xj);
+		}
+		return iterMax;
+	}
+	/*---------------- y += a x ;  y = x + b y ----------------*/
+	static void axpy(T a, Mat<T>& x, Mat<T>& y) {
+		T* yd = y.data; const T* xd = x.data;
+		Parallel::parallelFor(y.size(), Mat<T>::PARALLEL_N, [=](int st, int ed) {
+			for (int i = st; i < ed; i++) yd[i] += a * xd[i];
+		});
+	}
+	static void xpby(Mat<T>& x, T b, Mat<T>& y) {
+		T* yd = y.data; const T* xd = x.data;
+		Parallel::parallelFor(y.size(), Mat<T>::PARALLEL_N, [=](int st, int ed) {
+			for (int i = st; i < ed; i++) yd[i] = xd[i] + b * yd[i];
+		});
+	}
+};
+#endif